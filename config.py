@@ -4,7 +4,7 @@
 '''
 
 from config.validate import *
-from config import constants, memsys, globs, sim, dram_timing
+from config import constants, memsys, globs, sim, dram_timing, dram_power
 
 import configparser
 import os
@@ -31,7 +31,20 @@ if 'size_kb_per_core' in cfg['LLC']:
     cfg['LLC']['size_kb'] = str(int(cfg['LLC']['size_kb_per_core']) * int(cfg['CORE']['num_threads']))
 for c in caches:
     validate_cache_section(cfg[c])
+validate_llc_section(cfg['LLC'])
 validate_dram_section(cfg['DRAM'])
+# The far memory tier is optional.
+if 'FAR_MEMORY' not in cfg:
+    cfg['FAR_MEMORY'] = {}
+validate_far_memory_section(cfg['FAR_MEMORY'])
+# So is the DRAM cache.
+if 'DRAM_CACHE' not in cfg:
+    cfg['DRAM_CACHE'] = {}
+validate_dram_cache_section(cfg['DRAM_CACHE'], cfg['DRAM'])
+# So is the interconnect.
+if 'INTERCONNECT' not in cfg:
+    cfg['INTERCONNECT'] = {}
+validate_interconnect_section(cfg['INTERCONNECT'])
 validate_os_section(cfg['OS'])
 
 constants.write(cfg, build_id)
@@ -39,6 +52,7 @@ memsys.write(cfg, build_id)
 globs.write(cfg, build_id)
 sim.write(cfg, build_id)
 dram_timing.write(cfg, build_id)
+dram_power.write(cfg, build_id)
 
 ####################################################################
 ####################################################################
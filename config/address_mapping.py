@@ -0,0 +1,87 @@
+'''
+    author: Suhas Vittal
+    date:   19 October 2026
+'''
+
+####################################################################
+####################################################################
+
+'''
+    Mask-programmable address mappings (`address_mapping = MASK`).
+
+    Each bit of the channel, sub-channel, rank, bankgroup, bank, and row index is the
+    parity (XOR) of the line address bits selected by a mask. The masks of
+    a field are given LSB first as a comma-separated list, i.e.:
+
+        ba_masks = 0x4010, 0x8020
+
+    Any field that is not specified defaults to a MOP4 layout where each
+    channel/sub-channel/rank/bankgroup/bank bit is XORed with a row bit (permutation-based
+    interleaving). Rows default to the contiguous bits above all other fields.
+'''
+
+FIELDS = ['ch', 'sc', 'ra', 'bg', 'ba', 'row']
+
+def _log2(n: int) -> int:
+    return n.bit_length()-1
+
+def _gf2_rank(vectors: list[int]) -> int:
+    rank, basis = 0, []
+    for v in vectors:
+        for b in basis:
+            v = min(v, v ^ b)
+        if v != 0:
+            basis.append(v)
+            rank += 1
+    return rank
+
+def default_masks(dram_cfg) -> dict[str, list[int]]:
+    ch, sc, ra, bg, ba = [_log2(int(dram_cfg[x])) for x in ['channels', 'subchannels', 'ranks', 'bankgroups', 'banks']]
+    row, col = _log2(int(dram_cfg['rows'])), _log2(int(dram_cfg['columns']))
+    mop = _log2(4)
+    # MOP4 layout.
+    offsets = {'ch': mop, 'sc': mop+ch, 'bg': mop+ch+sc, 'ba': mop+ch+sc+bg, 'ra': mop+ch+sc+bg+ba}
+    widths = {'ch': ch, 'sc': sc, 'ra': ra, 'bg': bg, 'ba': ba}
+    row_off = ch+sc+ra+bg+ba+col
+    masks = {'row': [1 << (row_off+i) for i in range(row)]}
+    # XOR each non-row bit with the next row bit.
+    k = 0
+    for f in ['ch', 'sc', 'ra', 'bg', 'ba']:
+        masks[f] = []
+        for i in range(widths[f]):
+            masks[f].append((1 << (offsets[f]+i)) | (1 << (row_off + k % row)))
+            k += 1
+    return masks
+
+def get_mask_mapping(dram_cfg) -> str:
+    widths = {
+        'ch': _log2(int(dram_cfg['channels'])),
+        'sc': _log2(int(dram_cfg['subchannels'])),
+        'ra': _log2(int(dram_cfg['ranks'])),
+        'bg': _log2(int(dram_cfg['bankgroups'])),
+        'ba': _log2(int(dram_cfg['banks'])),
+        'row': _log2(int(dram_cfg['rows']))
+    }
+    masks = default_masks(dram_cfg)
+    for f in FIELDS:
+        key = f'{f}_masks'
+        if key in dram_cfg:
+            masks[f] = [int(x.strip(), 0) for x in dram_cfg[key].split(',') if x.strip() != '']
+        if len(masks[f]) != widths[f]:
+            print(f'config/address_mapping: {key} needs {widths[f]} masks, got {len(masks[f])}')
+            exit(1)
+    # If the masks are not linearly independent, then different lines alias to
+    # the same (channel, bank, row).
+    all_masks = [m for f in FIELDS for m in masks[f]]
+    if any(m == 0 for m in all_masks) or _gf2_rank(all_masks) != len(all_masks):
+        print('config/address_mapping: address masks are not linearly independent')
+        exit(1)
+
+    lines = ['#define DRAM_AM_MASK', '']
+    for f in FIELDS:
+        arr = ', '.join(f'0x{m:x}' for m in masks[f])
+        lines.append(f'constexpr std::array<uint64_t, {widths[f]}> DRAM_AM_{f.upper()}_MASKS{{{{{arr}}}}};')
+    return '\n'.join(lines)
+
+####################################################################
+####################################################################
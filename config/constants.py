@@ -2,6 +2,7 @@
     date:   4 December 2024 '''
 
 from .files import GEN_DIR, AUTOGEN_HEADER
+from .address_mapping import get_mask_mapping
 
 ####################################################################
 ####################################################################
@@ -20,21 +21,51 @@ def write(cfg, build):
     fetch_width = core_cfg['fetch_width']
     rob_size = core_cfg['rob_size']
     ftb_size = core_cfg['ftb_size']
+    fdip_depth = core_cfg['fdip_depth']
 
     ch, ra, bg, ba, row, col = dram_cfg['channels'], dram_cfg['ranks'], dram_cfg['bankgroups'],\
                                 dram_cfg['banks'], dram_cfg['rows'], dram_cfg['columns']
+    sc = dram_cfg['subchannels']
     BL = dram_cfg['BL']
     rq_size, wq_size, cmdq_size = dram_cfg['read_queue_size'], dram_cfg['write_queue_size'], dram_cfg['cmd_queue_size']
+    wq_high_wm, wq_low_wm = dram_cfg['write_high_watermark'], dram_cfg['write_low_watermark']
+    write_min_burst, read_preempt = dram_cfg['write_min_burst'], dram_cfg['read_preempt_drain'].lower()
     page_policy = dram_cfg['page_policy']
+    page_timeout, max_row_hits = dram_cfg['page_timeout'], dram_cfg['max_row_hits']
+    refresh_mode = dram_cfg['refresh_mode']
+    scheduler = dram_cfg['scheduler']
     # Address mapping is a little less straightforward
     am = dram_cfg['address_mapping']
     if am[:3] == 'MOP':
         mop_size = int(am[3:])
         am_txt = f'#define DRAM_AM_MOP {mop_size}'
+    elif am == 'MASK':
+        am_txt = get_mask_mapping(dram_cfg)
     else:
         am_txt = f'#define DRAM_AM_{am}'
 
+    far_cfg = cfg['FAR_MEMORY']
+    far_size_mb, far_latency, far_bw = far_cfg['size_mb'], far_cfg['latency_ns'], far_cfg['bandwidth_gbps']
+    far_qsize = far_cfg['queue_size']
+    placement, interleave_weight = far_cfg['placement'], far_cfg['interleave_weight']
+    mig_epoch, mig_max_pages, mig_hot_thresh = far_cfg['migration_epoch'], far_cfg['migration_max_pages'],\
+                                                far_cfg['migration_hot_threshold']
+    tlb_shootdown = far_cfg['tlb_shootdown_cycles']
+
+    dc_cfg = cfg['DRAM_CACHE']
+    dc_size_mb, dc_tags, dc_ways = dc_cfg['size_mb'], dc_cfg['tag_store'], dc_cfg['ways']
+    dc_tag_latency, dc_qsize = dc_cfg['tag_latency'], dc_cfg['queue_size']
+    dc_miss_pred = dc_cfg['miss_predictor'].lower()
+    dc_ch, dc_sc, dc_ra = dc_cfg['channels'], dc_cfg['subchannels'], dc_cfg['ranks']
+    dc_bg, dc_ba, dc_row, dc_col = dc_cfg['bankgroups'], dc_cfg['banks'], dc_cfg['rows'], dc_cfg['columns']
+    dc_BL = dc_cfg['BL']
+
+    noc_cfg = cfg['INTERCONNECT']
+    noc_topology, noc_link_width, noc_router_latency = noc_cfg['topology'], noc_cfg['link_width_bytes'],\
+                                                        noc_cfg['router_latency']
+
     pt_levels = os_cfg['levels']
+    shared_address_space = os_cfg['shared_address_space'].lower()
 
     # Finally, write to file. 
     with open(f'{GEN_DIR}/{build}/constants.h', 'w') as wr:
@@ -44,7 +75,9 @@ f'''{AUTOGEN_HEADER}
 #ifndef CONSTANTS_h
 #define CONSTANTS_h
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -56,6 +89,12 @@ constexpr size_t PTESIZE = 8;
 constexpr size_t PT_LEVELS = {pt_levels};
 
 constexpr size_t NUM_PTE_PER_TABLE = PAGESIZE/PTESIZE;
+/*
+ * If set, all cores share one address space (for multithreaded traces), and the
+ * private caches are kept coherent by a MESI directory (see `Directory` in
+ * `cache/directory.h`). Otherwise, each core has its own address space.
+ * */
+constexpr bool OS_SHARED_ADDRESS_SPACE = {shared_address_space};
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -64,11 +103,21 @@ constexpr size_t NUM_THREADS = {num_threads};
 constexpr size_t CORE_FETCH_WIDTH = {fetch_width};
 constexpr size_t CORE_ROB_SIZE = {rob_size};
 constexpr size_t CORE_FTB_SIZE = {ftb_size};
+/*
+ * Number of instructions that fetch-directed instruction prefetching reads ahead
+ * of fetch (0 disables it). Only used by the complex model.
+ * */
+constexpr size_t CORE_FDIP_DEPTH = {fdip_depth};
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
 constexpr size_t DRAM_CHANNELS = {ch};
+/*
+ * Sub-channels (DDR5) or pseudo-channels (HBM) per channel. These have
+ * independent banks and data buses but share the channel's command bus.
+ * */
+constexpr size_t DRAM_SUBCHANNELS = {sc};
 constexpr size_t DRAM_RANKS = {ra};
 constexpr size_t DRAM_BANKGROUPS = {bg};
 constexpr size_t DRAM_BANKS = {ba};
@@ -80,17 +129,94 @@ constexpr size_t DRAM_BURST_LENGTH = {BL};
 constexpr size_t DRAM_RQ_SIZE = {rq_size};
 constexpr size_t DRAM_WQ_SIZE = {wq_size};
 constexpr size_t DRAM_CMDQ_SIZE = {cmdq_size};
-
-constexpr size_t DRAM_SIZE_MB = DRAM_CHANNELS * DRAM_RANKS * DRAM_BANKGROUPS * DRAM_BANKS
+/*
+ * Write drain parameters (see `WriteDrainParams` in `io_bus.h`).
+ * */
+constexpr size_t DRAM_WQ_HIGH_WM = {wq_high_wm};
+constexpr size_t DRAM_WQ_LOW_WM = {wq_low_wm};
+constexpr size_t DRAM_WRITE_MIN_BURST = {write_min_burst};
+constexpr bool   DRAM_READ_PREEMPT_DRAIN = {read_preempt};
+
+constexpr size_t DRAM_SIZE_MB = DRAM_CHANNELS * DRAM_SUBCHANNELS * DRAM_RANKS * DRAM_BANKGROUPS * DRAM_BANKS
                                 * DRAM_ROWS * DRAM_COLUMNS * LINESIZE / (1024*1024);
 
 #define DRAM_PAGE_POLICY DRAMPagePolicy::{page_policy}
 
+/*
+ * `DRAM_PAGE_TIMEOUT` is only used by the `TIMEOUT` page policy. `DRAM_MAX_ROW_HITS` is
+ * the number of row hits after which a row may be closed for a pending row miss.
+ * */
+constexpr uint64_t DRAM_PAGE_TIMEOUT = {page_timeout};
+constexpr size_t   DRAM_MAX_ROW_HITS = {max_row_hits};
+
+#define DRAM_REFRESH_MODE DRAMRefreshMode::{refresh_mode}
+#define DRAM_SCHEDULER DRAMScheduler::{scheduler}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
 {am_txt}
 
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Far memory tier (a CXL Type-3 memory expander). Page frames past the end of
+ * DRAM belong to this tier. `FAR_MEM_SIZE_MB = 0` disables it.
+ * */
+constexpr size_t   FAR_MEM_SIZE_MB = {far_size_mb};
+constexpr uint64_t FAR_MEM_LATENCY_NS = {far_latency};
+constexpr double   FAR_MEM_BANDWIDTH_GBPS = {far_bw};
+constexpr size_t   FAR_MEM_QUEUE_SIZE = {far_qsize};
+/*
+ * Page placement and migration (see `MemPlacement` in `os/free_list.h` and
+ * `PageMigrator` in `os/migration.h`). Epochs and TLB shootdowns are in CPU cycles.
+ * */
+#define MEM_PLACEMENT MemPlacement::{placement}
+
+constexpr size_t   MEM_INTERLEAVE_WEIGHT = {interleave_weight};
+constexpr uint64_t MIGRATION_EPOCH = {mig_epoch};
+constexpr size_t   MIGRATION_MAX_PAGES = {mig_max_pages};
+constexpr uint64_t MIGRATION_HOT_THRESHOLD = {mig_hot_thresh};
+constexpr uint64_t TLB_SHOOTDOWN_CYCLES = {tlb_shootdown};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Memory-side DRAM cache (see `DRAMCache` in `dram/cache.h`). `DRAM_CACHE_SIZE_MB = 0`
+ * disables it. `DRAM_CACHE_TAG_LATENCY` (CPU cycles) is only used by `SRAM` tags.
+ * */
+constexpr size_t   DRAM_CACHE_SIZE_MB = {dc_size_mb};
+constexpr size_t   DRAM_CACHE_WAYS = {dc_ways};
+constexpr uint64_t DRAM_CACHE_TAG_LATENCY = {dc_tag_latency};
+constexpr size_t   DRAM_CACHE_QUEUE_SIZE = {dc_qsize};
+constexpr bool     DRAM_CACHE_MISS_PREDICTOR = {dc_miss_pred};
+
+#define DRAM_CACHE_TAGS DRAMCacheTags::{dc_tags}
+/*
+ * Organization of the DRAM cache's devices (see `DRAMCacheTiming` in `dram_timing.h`).
+ * The number of rows is derived from `DRAM_CACHE_SIZE_MB`.
+ * */
+constexpr size_t DRAM_CACHE_CHANNELS = {dc_ch};
+constexpr size_t DRAM_CACHE_SUBCHANNELS = {dc_sc};
+constexpr size_t DRAM_CACHE_RANKS = {dc_ra};
+constexpr size_t DRAM_CACHE_BANKGROUPS = {dc_bg};
+constexpr size_t DRAM_CACHE_BANKS = {dc_ba};
+constexpr size_t DRAM_CACHE_ROWS = {dc_row};
+constexpr size_t DRAM_CACHE_COLUMNS = {dc_col};
+
+constexpr size_t DRAM_CACHE_BURST_LENGTH = {dc_BL};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * On-chip interconnect between the cores, LLC slices and memory (see `Interconnect`
+ * in `interconnect.h`). The link width is in bytes, and the router latency in CPU cycles.
+ * */
+#define NOC_TOPOLOGY NOCTopology::{noc_topology}
+
+constexpr size_t   NOC_LINK_WIDTH = {noc_link_width};
+constexpr uint64_t NOC_ROUTER_LATENCY = {noc_router_latency};
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,61 @@
+'''
+    author: Suhas Vittal
+    date:   19 October 2026
+'''
+
+from .files import GEN_DIR, AUTOGEN_HEADER
+
+####################################################################
+####################################################################
+
+def write(cfg, build):
+    dram_type = cfg['DRAM']['dram_type']
+
+    # Currents are in mA and voltages in V (per device), so that
+    # mA * V * ns = pJ.
+    if dram_type == '4800':
+        # 16Gb x8 DDR5-4800 device. A 64-bit rank has 8 devices.
+        devices_per_rank = 8
+        VDD = 1.1
+        IDD0 = 68.0
+        IDD2N = 46.0
+        IDD3N = 60.0
+        IDD4R = 250.0
+        IDD4W = 235.0
+        IDD5B = 270.0
+    else:
+        print(f'Unsupported dram type: {dram_type}')
+        exit(1)
+
+    with open(f'{GEN_DIR}/{build}/dram_power.h', 'w') as wr:
+        wr.write(
+f'''{AUTOGEN_HEADER}
+
+#ifndef DRAM_POWER_h
+#define DRAM_POWER_h
+
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+constexpr size_t DRAM_DEVICES_PER_RANK = {devices_per_rank};
+
+constexpr double VDD = {VDD};
+
+constexpr double IDD0 = {IDD0};
+constexpr double IDD2N = {IDD2N};
+constexpr double IDD3N = {IDD3N};
+constexpr double IDD4R = {IDD4R};
+constexpr double IDD4W = {IDD4W};
+constexpr double IDD5B = {IDD5B};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // DRAM_POWER_h
+
+''')
+
+####################################################################
+####################################################################
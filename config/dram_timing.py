@@ -10,20 +10,31 @@ import math
 ####################################################################
 ####################################################################
 
-def write(cfg, build):
-    BL = int(cfg['DRAM']['BL'])
-    dram_freq = float(cfg['DRAM']['frequency_ghz'])
-    dram_type = cfg['DRAM']['dram_type']
-    
+TIMINGS = [
+    'CL', 'CWL', 'tRCD', 'tRP', 'tRAS', 'tRTP', 'tWR',
+    'tCCD_S', 'tCCD_S_WR', 'tCCD_S_WTR', 'tCCD_S_RTW',
+    'tCCD_L', 'tCCD_L_WR', 'tCCD_L_WTR', 'tCCD_L_RTW',
+    'tRTRS', 'tCCD_R', 'tCCD_R_WR', 'tCCD_R_WTR', 'tCCD_R_RTW',
+    'tRRD_S', 'tRRD_L', 'tFAW',
+    'tRFC', 'tRFCsb', 'tRFCpb', 'tREFI'
+]
+
+# Timings (in ns) that a device section may override with `<name>_ns`.
+NS_OVERRIDES = ['CL', 'tRCD', 'tRP', 'tRAS']
+
+def get_timings(dram_type: str, BL: int, dram_freq: float, ns_overrides: dict) -> dict:
     def ckcast(t_ns: float) -> int:
         return int(math.ceil(t_ns*dram_freq))
 
+    def ns(name: str, default: float) -> float:
+        return float(ns_overrides.get(name, default))
+
     if dram_type == '4800':
-        CL = ckcast(16.0)
+        CL = ckcast(ns('CL', 16.0))
         CWL = CL-2
-        tRCD = ckcast(16.0)
-        tRP = ckcast(16.0)
-        tRAS = ckcast(32.0)
+        tRCD = ckcast(ns('tRCD', 16.0))
+        tRP = ckcast(ns('tRP', 16.0))
+        tRAS = ckcast(ns('tRAS', 32.0))
         tRTP = max(12, ckcast(7.5))
         tWR = ckcast(30.0)
 
@@ -37,14 +48,95 @@ def write(cfg, build):
         tCCD_L_WTR = CWL + BL//2 + max(16, ckcast(10.0))
         tCCD_L_RTW = tCCD_L_WTR
 
+        # Rank-to-rank switching: CAS commands to different ranks are limited
+        # by the data bus (plus `tRTRS` bubble cycles).
+        tRTRS = 2
+        tCCD_R = BL//2 + tRTRS
+        tCCD_R_WR = BL//2 + tRTRS
+        tCCD_R_RTW = CL + BL//2 + tRTRS - CWL
+        tCCD_R_WTR = max(0, CWL + BL//2 + tRTRS - CL)
+
         tRRD_S = 8
         tRRD_L = max(8, ckcast(5.0))
         tFAW = max(32, ckcast(13.333))
         tRFC = ckcast(410.0)
+        tRFCsb = ckcast(190.0)
+        # DDR5 does not support per-bank refresh, so we use the same-bank timing.
+        tRFCpb = tRFCsb
         tREFI = ckcast(32e6/8192.0)
     else:
         print(f'Unsupported dram type: {dram_type}')
         exit(1)
+    t = locals()
+    return {name: t[name] for name in TIMINGS}
+
+####################################################################
+####################################################################
+
+def timing_struct(name: str, doc: str, timings: dict, body: str) -> str:
+    timing_txt = '\n'.join(f'    constexpr static uint64_t {t} = {timings[t]};' for t in TIMINGS)
+    return f'''/*
+{doc}
+ * */
+struct {name}
+{{
+{body}
+
+{timing_txt}
+}};'''
+
+def write(cfg, build):
+    dram_cfg, dc_cfg = cfg['DRAM'], cfg['DRAM_CACHE']
+    # Both devices run on the DRAM clock.
+    dram_freq = float(dram_cfg['frequency_ghz'])
+
+    dram_t = get_timings(dram_cfg['dram_type'], int(dram_cfg['BL']), dram_freq, {})
+    dc_ns = {t: dc_cfg[f'{t}_ns'] for t in NS_OVERRIDES if f'{t}_ns' in dc_cfg}
+    dc_t = get_timings(dc_cfg['dram_type'], int(dc_cfg['BL']), dram_freq, dc_ns)
+
+    dram_struct = timing_struct('DRAMTiming',
+''' * Main memory: the organization and address mapping are given by `constants.h` and
+ * `dram/address.h`.''',
+        dram_t,
+'''    constexpr static size_t CHANNELS = DRAM_CHANNELS;
+    constexpr static size_t SUBCHANNELS = DRAM_SUBCHANNELS;
+    constexpr static size_t RANKS = DRAM_RANKS;
+    constexpr static size_t BANKGROUPS = DRAM_BANKGROUPS;
+    constexpr static size_t BANKS = DRAM_BANKS;
+    constexpr static size_t BL = DRAM_BURST_LENGTH;
+
+    inline static size_t channel(uint64_t x) { return dram_channel(x); }
+    inline static size_t subchannel(uint64_t x) { return dram_subchannel(x); }
+    inline static size_t rank(uint64_t x) { return dram_rank(x); }
+    inline static size_t bankgroup(uint64_t x) { return dram_bankgroup(x); }
+    inline static size_t bank(uint64_t x) { return dram_bank(x); }
+    inline static size_t row(uint64_t x) { return dram_row(x); }''')
+
+    dc_struct = timing_struct('DRAMCacheTiming',
+''' * DRAM cache (see `DRAMCache` in `dram/cache.h`): device addresses are cache slots, and
+ * are mapped like `MOP4` (consecutive slots are in the same row, four at a time).''',
+        dc_t,
+'''    constexpr static size_t CHANNELS = DRAM_CACHE_CHANNELS;
+    constexpr static size_t SUBCHANNELS = DRAM_CACHE_SUBCHANNELS;
+    constexpr static size_t RANKS = DRAM_CACHE_RANKS;
+    constexpr static size_t BANKGROUPS = DRAM_CACHE_BANKGROUPS;
+    constexpr static size_t BANKS = DRAM_CACHE_BANKS;
+    constexpr static size_t BL = DRAM_CACHE_BURST_LENGTH;
+
+    constexpr static size_t CH_OFF = numeric_traits<4>::log2;
+    constexpr static size_t SC_OFF = CH_OFF + numeric_traits<CHANNELS>::log2;
+    constexpr static size_t BG_OFF = SC_OFF + numeric_traits<SUBCHANNELS>::log2;
+    constexpr static size_t BA_OFF = BG_OFF + numeric_traits<BANKGROUPS>::log2;
+    constexpr static size_t RA_OFF = BA_OFF + numeric_traits<BANKS>::log2;
+    constexpr static size_t ROW_OFF = RA_OFF + numeric_traits<RANKS>::log2
+                                        + numeric_traits<DRAM_CACHE_COLUMNS>::log2 - CH_OFF;
+
+    inline static size_t channel(uint64_t x) { return (x >> CH_OFF) & mask(CHANNELS); }
+    inline static size_t subchannel(uint64_t x) { return (x >> SC_OFF) & mask(SUBCHANNELS); }
+    inline static size_t rank(uint64_t x) { return (x >> RA_OFF) & mask(RANKS); }
+    inline static size_t bankgroup(uint64_t x) { return (x >> BG_OFF) & mask(BANKGROUPS); }
+    inline static size_t bank(uint64_t x) { return (x >> BA_OFF) & mask(BANKS); }
+    inline static size_t row(uint64_t x) { return x >> ROW_OFF; }''')
 
     with open(f'{GEN_DIR}/{build}/dram_timing.h', 'w') as wr:
         wr.write(
@@ -53,35 +145,25 @@ f'''{AUTOGEN_HEADER}
 #ifndef DRAM_TIMING_h
 #define DRAM_TIMING_h
 
+#include "constants.h"
+#include "dram/address.h"
+#include "util/numerics.h"
+
 #include <cstdint>
 
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Each device's organization, address mapping, and timings (in DRAM cycles).
+ * `DRAMChannel` is parameterized by one of these.
+ * */
+
+{dram_struct}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
-constexpr uint64_t CL = {CL};
-constexpr uint64_t CWL = {CWL};
-constexpr uint64_t tRCD = {tRCD};
-constexpr uint64_t tRP = {tRP};
-constexpr uint64_t tRAS = {tRAS};
-constexpr uint64_t tRTP = {tRTP};
-constexpr uint64_t tWR = {tWR};
-
-constexpr uint64_t tCCD_S = {tCCD_S};
-constexpr uint64_t tCCD_S_WR = {tCCD_S_WR};
-constexpr uint64_t tCCD_S_WTR = {tCCD_S_WTR};
-constexpr uint64_t tCCD_S_RTW = {tCCD_S_RTW};
-
-constexpr uint64_t tCCD_L = {tCCD_L};
-constexpr uint64_t tCCD_L_WR = {tCCD_L_WR};
-constexpr uint64_t tCCD_L_WTR = {tCCD_L_WTR};
-constexpr uint64_t tCCD_L_RTW = {tCCD_L_RTW};
-
-constexpr uint64_t tRRD_S = {tRRD_S};
-constexpr uint64_t tRRD_L = {tRRD_L};
-constexpr uint64_t tFAW = {tFAW};
-
-constexpr uint64_t tRFC = {tRFC};
-constexpr uint64_t tREFI = {tREFI};
+{dc_struct}
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
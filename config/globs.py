@@ -35,17 +35,23 @@ class Core;
 class OS;
 class LLCache;
 class DRAM;
+class Directory;
 
 using core_ptr = std::unique_ptr<Core>;
 using core_array_t = std::array<core_ptr, NUM_THREADS>;
 using os_ptr = std::unique_ptr<OS>;
 using llc_ptr = std::unique_ptr<LLCache>;
 using dram_ptr = std::unique_ptr<DRAM>;
+using directory_ptr = std::unique_ptr<Directory>;
 
 extern core_array_t GL_CORES;
 extern os_ptr       GL_OS;
 extern llc_ptr      GL_LLC;
 extern dram_ptr     GL_DRAM;
+/*
+ * Only created in the complex model if `OS_SHARED_ADDRESS_SPACE`.
+ * */
+extern directory_ptr GL_DIRECTORY;
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -17,9 +17,19 @@ def declare_cache_type(cfg, typename: str, next_typename: str) -> str:
     invalidate_on_hit = 'true' if (cfg['mode'] == 'INVALIDATE_ON_HIT') else 'false'
     next_is_invalidate_on_hit = 'true' if (cfg['mode'] == 'NEXT_IS_INVALIDATE_ON_HIT') else 'false'
 
+    prefetcher, pf_degree = cfg['prefetcher'], cfg['prefetch_degree']
+    pf_to_next = 'true' if (cfg['prefetch_to_next_level'] == 'true') else 'false'
+    # Prefetcher metadata takes ways from the cache.
+    meta_ways = int(cfg['prefetch_metadata_ways'])
+    data_ways = int(ways) - meta_ways
+    meta_lines = int(sets) * meta_ways
+
     cache_decl =\
 f'''
-struct {typename} : public CacheControl<{typename}, Cache<{sets},{ways},CacheReplPolicy::{repl}>, {next_typename}>
+struct {typename} : public CacheControl<{typename},
+                                        Cache<{sets},{data_ways},CacheReplPolicy::{repl}>,
+                                        {next_typename},
+                                        prefetcher_type<CachePrefetcher::{prefetcher},{meta_lines}>::type>
 {{
     constexpr static size_t RQ_SIZE = {rq_size};
     constexpr static size_t WQ_SIZE = {wq_size};
@@ -33,6 +43,10 @@ struct {typename} : public CacheControl<{typename}, Cache<{sets},{ways},CacheRep
     constexpr static bool INVALIDATE_ON_HIT = {invalidate_on_hit};
     constexpr static bool NEXT_IS_INVALIDATE_ON_HIT = {next_is_invalidate_on_hit};
 
+    constexpr static size_t PREFETCH_DEGREE = {pf_degree};
+    constexpr static bool PREFETCH_TO_NEXT_LEVEL = {pf_to_next};
+    constexpr static size_t PREFETCH_METADATA_WAYS = {meta_ways};
+
     {typename}(std::string name, CacheControl::next_ptr& n)
         :CacheControl(name, n)
     {{}}
@@ -40,6 +54,27 @@ struct {typename} : public CacheControl<{typename}, Cache<{sets},{ways},CacheRep
 '''
     return cache_decl
 
+def declare_sliced_cache_type(cfg, typename: str, next_typename: str, has_noc: bool) -> str:
+    slices, hop_latency = int(cfg['slices']), cfg['slice_hop_latency']
+    # Each slice is a cache with `1/slices`-th of the sets.
+    slice_cfg = dict(cfg)
+    slice_cfg['sets'] = str(int(cfg['sets']) // slices)
+    slice_typename = f'{typename}Slice'
+    # With an interconnect, the slices reach the next level through a port.
+    slice_next_typename = f'InterconnectPort<{next_typename}>' if has_noc else next_typename
+
+    cache_decl = declare_cache_type(slice_cfg, slice_typename, slice_next_typename)
+    cache_decl +=\
+f'''
+struct {typename} : public SlicedCacheControl<{slice_typename},{next_typename},{slices},{slice_cfg['sets']},{hop_latency}>
+{{
+    {typename}(std::string name, SlicedCacheControl::next_ptr& n)
+        :SlicedCacheControl(name, n)
+    {{}}
+}};
+'''
+    return cache_decl
+
 ####################################################################
 ####################################################################
 
@@ -58,6 +93,7 @@ f'''{AUTOGEN_HEADER}
 #define MEMSYS_h
 
 #include "cache/control.h"
+#include "cache/sliced.h"
 #include "dram.h"
 {ptw_inc}
 #include <memory>
@@ -90,13 +126,25 @@ f'''{AUTOGEN_HEADER}
     for (i, c) in enumerate(caches):
         typename = cache_typenames[c]
         ii = next_idx[i]
+        # TLBs hold page numbers, and prefetches to the next level need a cache there.
+        if c.endswith('TLB') and cfg[c]['prefetcher'] != 'NONE':
+            print(f'config/memsys: {c} cannot have a prefetcher')
+            exit(1)
         if type(ii) is str:
             next_typename = ii
+            if cfg[c]['prefetch_to_next_level'] == 'true':
+                print(f'config/memsys: {c} cannot prefetch to the next level ({ii})')
+                exit(1)
         else:
             next_typename = cache_typenames[caches[ii]]
             if cfg[caches[ii]]['mode'] == 'INVALIDATE_ON_HIT':
                 cfg[c]['mode'] = 'NEXT_IS_INVALIDATE_ON_HIT'
-        wr.write(declare_cache_type(cfg[c], typename, next_typename))
+        # The LLC is sliced if it has more than one slice, or if there is an interconnect.
+        has_noc = cfg['INTERCONNECT']['topology'] != 'NONE'
+        if c == 'LLC' and (int(cfg[c]['slices']) > 1 or has_noc):
+            wr.write(declare_sliced_cache_type(cfg[c], typename, next_typename, has_noc))
+        else:
+            wr.write(declare_cache_type(cfg[c], typename, next_typename))
     wr.write(
 '''
 
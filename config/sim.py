@@ -17,7 +17,8 @@ CHANNEL_SL_TIMINGS = [
 ]
 
 CHANNEL_TIMINGS = [
-    'tFAW', 'tRFC', 'tREFI'
+    'tRTRS', 'tCCD_R', 'tCCD_R_WR', 'tCCD_R_WTR', 'tCCD_R_RTW',
+    'tFAW', 'tRFC', 'tRFCsb', 'tRFCpb', 'tREFI'
 ]
 
 ####################################################################
@@ -39,7 +40,15 @@ def get_cache_params(cfg, caches: list[str]) -> str:
         wq = ccfg['write_queue_size']
         pq = ccfg['prefetch_queue_size']
 
-        calls[c] = f'{size_kb}, {sets}, {ways}, \"{repl}\", {num_mshr}, {num_rw}, {latency}, {rq}, {wq}, {pq}'
+        pf = ccfg['prefetcher']
+        if pf != 'NONE':
+            pf += f'({ccfg["prefetch_degree"]})'
+            if ccfg['prefetch_to_next_level'] == 'true':
+                pf += ' -> next'
+            if int(ccfg['prefetch_metadata_ways']) > 0:
+                pf += f' {ccfg["prefetch_metadata_ways"]}w'
+
+        calls[c] = f'{size_kb}, {sets}, {ways}, \"{repl}\", {num_mshr}, {num_rw}, {latency}, {rq}, {wq}, {pq}, \"{pf}\"'
     return calls
 
 ####################################################################
@@ -56,18 +65,70 @@ def write(cfg, build):
     #
     # Cache params:
     cache_params = get_cache_params(cfg, ['L1i', 'L1d', 'L2', 'LLC'])
+    noc_cfg = cfg['INTERCONNECT']
+    llc_slices = ''
+    if int(cfg['LLC']['slices']) > 1:
+        llc_slices = f"LLC Slices: {cfg['LLC']['slices']} (sets per slice = {int(cfg['LLC']['sets']) // int(cfg['LLC']['slices'])}"
+        # The hop latency is only used without an interconnect.
+        if noc_cfg['topology'] == 'NONE':
+            llc_slices += f", hop latency = {cfg['LLC']['slice_hop_latency']} cycles"
+        llc_slices += ')\\n'
+    noc = ''
+    if noc_cfg['topology'] != 'NONE':
+        noc = f"Interconnect: topology = {noc_cfg['topology']}, link width = {noc_cfg['link_width_bytes']}B, "\
+                f"router latency = {noc_cfg['router_latency']} cycles\\n"
+    coherence = ''
+    if cfg['OS']['shared_address_space'].lower() == 'true':
+        # Only the complex model has private caches to keep coherent.
+        coherence = 'Shared Address Space: yes'
+        if sim_model == 'complex':
+            coherence += ' (MESI directory at the LLC)'
+        coherence += '\\n'
 
     # DRAM timings:
-    bank_timing_calls = '\n\t'.join(f'list_dram(out, \"{t}\", {t});' for t in BANK_TIMINGS)
-    channel_timing_calls = '\n\t'.join(f'list_dram(out, \"{t}\", {t});' for t in CHANNEL_TIMINGS)
+    bank_timing_calls = '\n\t'.join(f'list_dram(out, \"{t}\", DRAMTiming::{t});' for t in BANK_TIMINGS)
+    channel_timing_calls = '\n\t'.join(f'list_dram(out, \"{t}\", DRAMTiming::{t});' for t in CHANNEL_TIMINGS)
     # SL timings are a bit more complicated to implement
     sl_timing_calls = []
     for t in CHANNEL_SL_TIMINGS:
         name, tS, tL = t % '_S(L)', t % '_S', t % '_L'
-        sl_timing_calls.append(f'list_dram_sl(out, \"{name}\", {tS}, {tL});')
+        sl_timing_calls.append(f'list_dram_sl(out, \"{name}\", DRAMTiming::{tS}, DRAMTiming::{tL});')
     sl_timing_calls = '\n\t'.join(sl_timing_calls)
     dram_page_policy = cfg['DRAM']['page_policy']
+    if dram_page_policy == 'TIMEOUT':
+        dram_page_policy += f" (timeout = {cfg['DRAM']['page_timeout']})"
+    dram_max_row_hits = cfg['DRAM']['max_row_hits']
+    dram_drain = f"high = {cfg['DRAM']['write_high_watermark']}, low = {cfg['DRAM']['write_low_watermark']}, "\
+                    f"min burst = {cfg['DRAM']['write_min_burst']}, read preempt = {cfg['DRAM']['read_preempt_drain']}"
+    dram_refresh_mode = cfg['DRAM']['refresh_mode']
+    dram_scheduler = cfg['DRAM']['scheduler']
     dram_am = cfg['DRAM']['address_mapping']
+    far_cfg = cfg['FAR_MEMORY']
+    far_mem = ''
+    if int(far_cfg['size_mb']) > 0:
+        far_placement = far_cfg['placement']
+        if far_placement == 'INTERLEAVE':
+            far_placement += f" (weight = {far_cfg['interleave_weight']})"
+        elif far_placement == 'HOTNESS':
+            far_placement += f" (epoch = {far_cfg['migration_epoch']}, max pages = {far_cfg['migration_max_pages']}, "\
+                                f"threshold = {far_cfg['migration_hot_threshold']})"
+        far_mem = f"Far Memory: size = {far_cfg['size_mb']}MB, latency = {far_cfg['latency_ns']}ns, "\
+                    f"bandwidth = {far_cfg['bandwidth_gbps']}GB/s, placement = {far_placement}, "\
+                    f"TLB shootdown = {far_cfg['tlb_shootdown_cycles']} cycles\\n"
+
+    dc_cfg = cfg['DRAM_CACHE']
+    dram_cache = ''
+    if int(dc_cfg['size_mb']) > 0:
+        dc_tags = dc_cfg['tag_store']
+        if dc_tags == 'SRAM':
+            dc_tags += f" (ways = {dc_cfg['ways']}, tag latency = {dc_cfg['tag_latency']})"
+        else:
+            dc_tags += f" (miss predictor = {dc_cfg['miss_predictor']})"
+        dc_org = 'x'.join(dc_cfg[x] for x in ['channels', 'subchannels', 'ranks', 'bankgroups', 'banks', 'rows', 'columns'])
+        dc_timing = '/'.join(f'" << DRAMCacheTiming::{t} << "' for t in ['CL', 'tRCD', 'tRP', 'tRAS'])
+        dram_cache = f"DRAM Cache: size = {dc_cfg['size_mb']}MB, tags = {dc_tags}\\n"\
+                        f"DRAM Cache Devices: ch x sc x ra x bg x ba x row x col = {dc_org}, BL = {dc_cfg['BL']}, "\
+                        f"CL/tRCD/tRP/tRAS = {dc_timing} nCK\\n"
 
     # OS params:
     ptwc_params = ''
@@ -81,6 +142,10 @@ def write(cfg, build):
                 ptwc_params += ', '
             ptwc_params += f'{{{sets},{ways}}}'
         ptwc_params = f'{{ {ptwc_params} }}'
+    # The directory has as many entries as the LLC.
+    directory_init = ''
+    if sim_model == 'complex' and cfg['OS']['shared_address_space'].lower() == 'true':
+        directory_init = f"\n    GL_DIRECTORY = directory_ptr(new Directory({cfg['LLC']['sets']}, {cfg['LLC']['ways']}));"
 
     # Progress params:
     epoch_size = 50_000_000
@@ -144,6 +209,7 @@ fr'''{AUTOGEN_HEADER}
 #include "globals.h"
 #include "memsys.h"
 
+#include "cache/directory.h"
 #include "dram/address.h"
 
 #include <sstream>
@@ -155,7 +221,7 @@ void
 sim_init(void)
 {{
     GL_DRAM = dram_ptr(new DRAM({cpu_freq}, {dram_freq}));
-    GL_LLC = llc_ptr(new LLCache("LLC", GL_DRAM));
+    GL_LLC = llc_ptr(new LLCache("LLC", GL_DRAM));{directory_init}
     for (size_t i = 0; i < NUM_THREADS; i++)
         GL_CORES[i] = core_ptr(new Core(i, OPT_TRACE_FILE));
     GL_OS = os_ptr(new OS({ptwc_params}));
@@ -183,7 +249,8 @@ list_cache_params(
     size_t latency,
     size_t rq,
     size_t wq,
-    size_t pq)
+    size_t pq,
+    std::string_view pf)
 {{
     std::string qstr = std::to_string(rq) + ":" + std::to_string(wq) + ":" + std::to_string(pq);
     out << std::setw(12) << std::left << name
@@ -195,6 +262,7 @@ list_cache_params(
         << std::setw(8) << std::left << num_ports
         << std::setw(12) << std::left << latency
         << std::setw(12) << std::left << qstr
+        << std::setw(16) << std::left << pf
         << "\n";
 }}
 
@@ -236,6 +304,7 @@ print_config(std::ostream& out)
     list(out, "CORE_FETCH_WIDTH", CORE_FETCH_WIDTH);
     list(out, "CORE_ROB_SIZE", CORE_ROB_SIZE);
     list(out, "CORE_FTB_SIZE", CORE_FTB_SIZE);
+    list(out, "CORE_FDIP_DEPTH", CORE_FDIP_DEPTH);
 
     // List cache parameters.
     out << BAR << "\n"
@@ -248,15 +317,23 @@ print_config(std::ostream& out)
         << std::setw(8) << std::left << "PORTS"
         << std::setw(12) << std::left << "LATENCY"
         << std::setw(12) << std::left << "RQ:WQ:PQ"
+        << std::setw(16) << std::left << "PREFETCHER"
         << "\n" << BAR << "\n";
     list_cache_params(out, "L1I$", {cache_params['L1i']});
     list_cache_params(out, "L1D$", {cache_params['L1d']});
     list_cache_params(out, "L2$", {cache_params['L2']});
     list_cache_params(out, "LLC", {cache_params['LLC']});
+    out << "{llc_slices}"
+        << "{noc}"
+        << "{coherence}";
 
     out << BAR << "\n"
         << "DRAM frequency = " << {dram_freq} << "GHz, tCK = " << {tCK:.5f} << "\n"
-        << "Page Policy = {dram_page_policy}, Address Mapping = {dram_am}\n";
+        << "Page Policy = {dram_page_policy}, Address Mapping = {dram_am}, Refresh Mode = {dram_refresh_mode}\n"
+        << "Scheduler = {dram_scheduler}, Max Row Hits = {dram_max_row_hits}\n"
+        << "Write Drain: {dram_drain}\n"
+        << "{far_mem}"
+        << "{dram_cache}";
     print_address_mapping(out);
     out << "\n"
         << std::setw(24) << std::left << "DRAM TIMING"
@@ -19,7 +19,8 @@ def validate_core_section(cfg) -> bool:
         ('num_threads', 1),
         ('fetch_width', 4),
         ('rob_size', 256),
-        ('ftb_size', 64)
+        ('ftb_size', 64),
+        ('fdip_depth', 0)
     ]
     update_cfg_with_optionals(cfg, optionals)
     return True
@@ -48,9 +49,38 @@ def validate_cache_section(cfg) -> bool:
     # Now check optionals
     optionals = [
         ('mode', ''),
-        ('replacement_policy', 'LRU')
+        ('replacement_policy', 'LRU'),
+        ('prefetcher', 'NONE'),
+        ('prefetch_degree', '1'),
+        ('prefetch_to_next_level', 'false'),
+        ('prefetch_metadata_ways', '0')
     ]
     update_cfg_with_optionals(cfg, optionals)
+    if cfg['replacement_policy'] not in ['LRU', 'RAND', 'SRRIP', 'PERFECT', 'SHIP', 'HAWKEYE', 'DRRIP', 'TA_DRRIP']:
+        print('config/validate: cache replacement_policy must be LRU, RAND, SRRIP, PERFECT, SHIP, HAWKEYE, DRRIP, or TA_DRRIP')
+        exit(1)
+    if cfg['prefetcher'] not in ['NONE', 'NEXT_LINE', 'IP_STRIDE', 'SPP', 'TEMPORAL']:
+        print('config/validate: cache prefetcher must be NONE, NEXT_LINE, IP_STRIDE, SPP, or TEMPORAL')
+        exit(1)
+    meta_ways = int(cfg['prefetch_metadata_ways'])
+    if (cfg['prefetcher'] == 'TEMPORAL') != (meta_ways > 0):
+        print('config/validate: prefetch_metadata_ways must be set for (and only for) the TEMPORAL prefetcher')
+        exit(1)
+    if meta_ways >= int(cfg['ways']):
+        print('config/validate: prefetch_metadata_ways must be less than the number of ways')
+        exit(1)
+    return True
+
+def validate_llc_section(cfg) -> bool:
+    optionals = [
+        ('slices', '1'),
+        ('slice_hop_latency', '1')
+    ]
+    update_cfg_with_optionals(cfg, optionals)
+    slices = int(cfg['slices'])
+    if slices < 1 or int(cfg['sets']) % slices != 0:
+        print('config/validate: LLC slices must divide the number of sets')
+        exit(1)
     return True
 
 ####################################################################
@@ -70,12 +100,122 @@ def validate_dram_section(cfg) -> bool:
     if not all(x in cfg for x in required):
         return False
     optionals = [
+        ('subchannels', '1'),
         ('BL', '16'),
         ('cmd_queue_size', '16'),
         ('page_policy', 'OPEN'),
-        ('address_mapping', 'MOP4')
+        ('page_timeout', '200'),
+        ('max_row_hits', '4'),
+        ('refresh_mode', 'ALL_BANK'),
+        ('scheduler', 'FRFCFS'),
+        ('address_mapping', 'MOP4'),
+        ('write_high_watermark', cfg['write_queue_size']),
+        ('write_low_watermark', '0'),
+        ('write_min_burst', '0'),
+        ('read_preempt_drain', 'false')
     ]
     update_cfg_with_optionals(cfg, optionals)
+    if cfg['page_policy'] not in ['OPEN', 'CLOSE', 'TIMEOUT', 'PREDICTIVE']:
+        print('config/validate: DRAM page_policy must be OPEN, CLOSE, TIMEOUT, or PREDICTIVE')
+        exit(1)
+    if cfg['refresh_mode'] not in ['ALL_BANK', 'SAME_BANK', 'PER_BANK']:
+        print('config/validate: DRAM refresh_mode must be ALL_BANK, SAME_BANK, or PER_BANK')
+        exit(1)
+    if cfg['scheduler'] not in ['FRFCFS', 'BLISS', 'PARBS']:
+        print('config/validate: DRAM scheduler must be FRFCFS, BLISS, or PARBS')
+        exit(1)
+    am = cfg['address_mapping']
+    mop_ok = am[:3] == 'MOP' and am[3:].isdigit() and int(am[3:]) > 0 and (int(am[3:]) & (int(am[3:])-1)) == 0
+    if not mop_ok and am not in ['COFFEELAKE', 'SKYLAKE', 'MASK']:
+        print('config/validate: DRAM address_mapping must be MOP<n> (n a power of 2), COFFEELAKE, SKYLAKE, or MASK')
+        exit(1)
+    if int(cfg['write_low_watermark']) >= int(cfg['write_high_watermark']) \
+            or int(cfg['write_high_watermark']) > int(cfg['write_queue_size']):
+        print('config/validate: need write_low_watermark < write_high_watermark <= write_queue_size')
+        exit(1)
+    return True
+
+####################################################################
+####################################################################
+
+def validate_far_memory_section(cfg) -> bool:
+    optionals = [
+        ('size_mb', '0'),
+        ('latency_ns', '170'),
+        ('bandwidth_gbps', '32'),
+        ('queue_size', '64'),
+        ('placement', 'FIRST_TOUCH'),
+        ('interleave_weight', '1'),
+        ('migration_epoch', '1000000'),
+        ('migration_max_pages', '64'),
+        ('migration_hot_threshold', '8'),
+        ('tlb_shootdown_cycles', '4000')
+    ]
+    update_cfg_with_optionals(cfg, optionals)
+    if cfg['placement'] not in ['FIRST_TOUCH', 'INTERLEAVE', 'HOTNESS']:
+        print('config/validate: far memory placement must be FIRST_TOUCH, INTERLEAVE, or HOTNESS')
+        exit(1)
+    if (int(cfg['size_mb']) * 1024*1024 // 4096) % 64 != 0:
+        print('config/validate: far memory size_mb must be a multiple of 64 page frames')
+        exit(1)
+    return True
+
+####################################################################
+####################################################################
+
+def validate_dram_cache_section(cfg, dram_cfg) -> bool:
+    optionals = [
+        ('size_mb', '0'),
+        ('tag_store', 'ALLOY'),
+        ('ways', '1'),
+        ('tag_latency', '4'),
+        ('queue_size', '64'),
+        ('miss_predictor', 'true')
+    ]
+    # The cache's devices default to the organization and timing of main memory. Its
+    # timings may also be overridden in ns (see `NS_OVERRIDES` in `dram_timing.py`).
+    for x in ['dram_type', 'channels', 'subchannels', 'ranks', 'bankgroups', 'banks', 'columns', 'BL']:
+        optionals.append((x, dram_cfg[x]))
+    update_cfg_with_optionals(cfg, optionals)
+    if cfg['tag_store'] not in ['ALLOY', 'SRAM']:
+        print('config/validate: DRAM cache tag_store must be ALLOY or SRAM')
+        exit(1)
+    # Alloy caches are direct-mapped (the tag is read with the data).
+    if cfg['tag_store'] == 'ALLOY':
+        cfg['ways'] = '1'
+    for x in ['channels', 'subchannels', 'ranks', 'bankgroups', 'banks', 'columns']:
+        n = int(cfg[x])
+        if n < 1 or (n & (n-1)) != 0:
+            print(f'config/validate: DRAM cache {x} must be a power of 2')
+            exit(1)
+    # Slots are mapped like `MOP4`, so each row must hold at least four lines.
+    if int(cfg['columns']) < 4:
+        print('config/validate: DRAM cache columns must be at least 4')
+        exit(1)
+    # The number of rows is whatever is needed to hold `size_mb`.
+    lines_per_row = 1
+    for x in ['channels', 'subchannels', 'ranks', 'bankgroups', 'banks', 'columns']:
+        lines_per_row *= int(cfg[x])
+    num_lines = int(cfg['size_mb'])*1024*1024 // 64
+    if num_lines % lines_per_row != 0:
+        print(f'config/validate: DRAM cache size_mb must be a multiple of {lines_per_row*64} bytes')
+        exit(1)
+    cfg['rows'] = str(max(1, num_lines // lines_per_row))
+    return True
+
+def validate_interconnect_section(cfg) -> bool:
+    optionals = [
+        ('topology', 'NONE'),
+        ('link_width_bytes', '32'),
+        ('router_latency', '1')
+    ]
+    update_cfg_with_optionals(cfg, optionals)
+    if cfg['topology'] not in ['NONE', 'RING', 'MESH']:
+        print('config/validate: interconnect topology must be NONE, RING, or MESH')
+        exit(1)
+    if int(cfg['link_width_bytes']) < 1:
+        print('config/validate: interconnect link_width_bytes must be positive')
+        exit(1)
     return True
 
 ####################################################################
@@ -84,6 +224,10 @@ def validate_dram_section(cfg) -> bool:
 def validate_os_section(cfg) -> bool:
     if 'levels' not in cfg:
         return False
+    optionals = [
+        ('shared_address_space', 'false')
+    ]
+    update_cfg_with_optionals(cfg, optionals)
     pt_levels = int(cfg['levels'])
     return all(f'ptwc_{i}_sw' in cfg for i in range(1, pt_levels))
 
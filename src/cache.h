@@ -6,12 +6,15 @@
 #ifndef CACHE_h
 #define CACHE_h
 
+#include "cache/prefetch.h"
+#include "cache/repl.h"
 #include "util/numerics.h"
 
 #include <array>
 #include <cstdint>
 #include <optional>
 #include <random>
+#include <type_traits>
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -23,12 +26,23 @@ extern uint64_t GL_CYCLE;
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
-enum class CacheReplPolicy { LRU, RAND, SRRIP, PERFECT };
+/*
+ * `DRRIP` and `TA_DRRIP` choose between SRRIP and BRRIP insertion by set dueling, and
+ *  `TA_DRRIP` does so separately for each core.
+ * `SHIP` and `HAWKEYE` use the instruction address of each access.
+ * (see `cache/repl.h`)
+ * */
+enum class CacheReplPolicy { LRU, RAND, SRRIP, PERFECT, SHIP, HAWKEYE, DRRIP, TA_DRRIP };
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
 constexpr uint8_t SRRIP_MAX = 7;
+/*
+ * BRRIP inserts lines with the SRRIP priority once every `BRRIP_EPSILON` fills (and with
+ * the lowest priority otherwise).
+ * */
+constexpr size_t  BRRIP_EPSILON = 32;
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -43,13 +57,38 @@ struct CacheEntry
      * */
     uint64_t timestamp;
     uint8_t  rrpv;
+    /*
+     * The instruction address that filled the line (or last accessed it, for `HAWKEYE`),
+     * and whether the line was reused (for `SHIP`).
+     * */
+    uint64_t ip;
+    bool     reused =false;
+    /*
+     * The core that filled the line.
+     * */
+    uint8_t coreid;
+    /*
+     * Set if the line was filled by a prefetch (that no demand access was waiting on),
+     * and cleared on the first demand access. `pf_source` is the prefetcher that
+     * issued the prefetch.
+     * */
+    bool            prefetched =false;
+    CachePrefetcher pf_source =CachePrefetcher::NONE;
 
     CacheEntry(void) =default;
-    CacheEntry(uint64_t addr, size_t num_refs)
+    CacheEntry(uint64_t addr, 
+                size_t num_refs,
+                CachePrefetcher pf=CachePrefetcher::NONE,
+                uint64_t _ip=0,
+                uint8_t _coreid=0)
         :valid(true),
         address(addr),
         timestamp(GL_CYCLE),
-        rrpv(num_refs > 1 ? SRRIP_MAX : 1)
+        rrpv(num_refs > 1 ? SRRIP_MAX : 1),
+        ip(_ip),
+        coreid(_coreid),
+        prefetched(pf != CachePrefetcher::NONE),
+        pf_source(pf)
     {}
 };
 
@@ -63,24 +102,66 @@ private:
     using entry_t      = CacheEntry;
     using cset_t       = std::array<entry_t, WAYS>;
     using cset_array_t = std::array<cset_t, SETS>;
+    /*
+     * `HAWKEYE` samples up to 64 sets.
+     * */
+    constexpr static size_t HAWKEYE_SAMPLED_SETS = SETS < 64 ? SETS : 64;
+
+    using ship_t = std::conditional_t<POL == CacheReplPolicy::SHIP, SHiPPredictor, NoReplState>;
+    using hawkeye_t = std::conditional_t<POL == CacheReplPolicy::HAWKEYE, HawkeyePredictor<WAYS>, NoReplState>;
+    using drrip_t = std::conditional_t<POL == CacheReplPolicy::DRRIP, DRRIPDueling<SETS, 1>,
+                    std::conditional_t<POL == CacheReplPolicy::TA_DRRIP, DRRIPDueling<SETS, NUM_THREADS>,
+                                        NoReplState>>;
+
+    constexpr static bool IS_RRIP = POL == CacheReplPolicy::SRRIP
+                                    || POL == CacheReplPolicy::SHIP
+                                    || POL == CacheReplPolicy::DRRIP
+                                    || POL == CacheReplPolicy::TA_DRRIP;
     
     cset_array_t csets_{};
     std::mt19937_64 rng_{0};
+
+    ship_t    ship_{};
+    hawkeye_t hawkeye_;
+    drrip_t   drrip_{};
 public:
     using fill_result_t = std::optional<CacheEntry>;
 
-    Cache(void) =default;
-
-    bool probe(uint64_t, bool write=false);
+    Cache(void);
+    /*
+     * `ip` is the instruction address of the access (or 0 if unknown).
+     * */
+    bool probe(uint64_t, bool write=false, uint64_t ip=0);
+    /*
+     * Like `probe`, but does not update replacement metadata.
+     * */
+    bool contains(uint64_t);
     bool mark_dirty(uint64_t);
+    /*
+     * Clears the prefetched bit of the line, and returns true if it was set.
+     * */
+    bool clear_prefetched(uint64_t);
+    /*
+     * Clears the dirty bit of the line, and returns true if it was set.
+     * */
+    bool clear_dirty(uint64_t);
     /*
      * `num_refs` here corresponds to the number of MSHR/instruction references
      * at the time of install. Necessary for SRRIP, for example.
      * */
-    fill_result_t fill(uint64_t, size_t num_refs);
+    fill_result_t fill(uint64_t, 
+                        size_t num_refs,
+                        CachePrefetcher pf=CachePrefetcher::NONE,
+                        uint64_t ip=0,
+                        uint8_t coreid=0);
     fill_result_t fill(entry_t&&);
 
     void invalidate(uint64_t);
+    /*
+     * Like `invalidate`, but the line need not be in the cache. Returns true if the
+     * line was dirty.
+     * */
+    bool remove(uint64_t);
     /*
      * Counts number of elements in cache meeting criteria. If `get_occupancy(void)` is
      * used, then this just counts the number of valid elements in the cache.
@@ -98,14 +179,31 @@ public:
 private:
     typename cset_t::iterator find_victim(cset_t&);
     /*
-     * Update replacement metadata for the entry.
+     * Update replacement metadata for the entry on a hit by `ip`.
+     * */
+    void update(entry_t&, uint64_t ip);
+    /*
+     * Sets the insertion priority of `e` (for `SHIP`, `HAWKEYE`, and DRRIP).
      * */
-    void update(entry_t&);
+    void insert(cset_t&, entry_t& e);
 
     inline cset_t& get_set(uint64_t x)
     {
         return csets_.at(fast_mod<SETS>(x));
     }
+    /*
+     * Returns the index of the set in the `HAWKEYE` sampler, or `HAWKEYE_SAMPLED_SETS`
+     * if the set is not sampled. One set is sampled in each group of `STRIDE` sets, at a
+     * different offset in each group: the low bits of the set index are the line's offset
+     * in its page, so sampling the same offset would only sample one line of each page.
+     * */
+    inline size_t hawkeye_sample_index(uint64_t x)
+    {
+        constexpr size_t STRIDE = SETS / HAWKEYE_SAMPLED_SETS;
+        size_t set = fast_mod<SETS>(x),
+               i = set / STRIDE;
+        return fast_mod<STRIDE>(set) == fast_mod<STRIDE>(i) ? i : HAWKEYE_SAMPLED_SETS;
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////
@@ -13,12 +13,32 @@
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
+__TEMPLATE_HEADER__
+__TEMPLATE_CLASS__::Cache()
+    :hawkeye_([] {
+        if constexpr (POL == CacheReplPolicy::HAWKEYE)
+            return hawkeye_t(HAWKEYE_SAMPLED_SETS);
+        else
+            return hawkeye_t{};
+    }())
+{}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
 __TEMPLATE_HEADER__ bool
-__TEMPLATE_CLASS__::probe(uint64_t addr, bool write)
+__TEMPLATE_CLASS__::probe(uint64_t addr, bool write, uint64_t ip)
 {
     if constexpr (POL == CacheReplPolicy::PERFECT)
         return true;
 
+    // Accesses without an instruction address (e.g., page walks) cannot train the predictor.
+    if constexpr (POL == CacheReplPolicy::HAWKEYE) {
+        size_t i = hawkeye_sample_index(addr);
+        if (i < HAWKEYE_SAMPLED_SETS && ip != 0)
+            hawkeye_.access(i, addr, ip);
+    }
+
     cset_t& s = get_set(addr);
     auto it = std::find_if(s.begin(), s.end(),
                     [addr] (entry_t& e)
@@ -28,12 +48,26 @@ __TEMPLATE_CLASS__::probe(uint64_t addr, bool write)
     if (it == s.end()) {
         return false;
     } else {
-        update(*it);
+        update(*it, ip);
         it->dirty = write;
         return true;
     }
 }
 
+__TEMPLATE_HEADER__ bool
+__TEMPLATE_CLASS__::contains(uint64_t addr)
+{
+    if constexpr (POL == CacheReplPolicy::PERFECT)
+        return true;
+
+    cset_t& s = get_set(addr);
+    return std::any_of(s.begin(), s.end(),
+                    [addr] (entry_t& e)
+                    {
+                        return e.valid && e.address == addr;
+                    });
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
@@ -57,13 +91,49 @@ __TEMPLATE_CLASS__::mark_dirty(uint64_t addr)
     }
 }
 
+__TEMPLATE_HEADER__ bool
+__TEMPLATE_CLASS__::clear_prefetched(uint64_t addr)
+{
+    if constexpr (POL == CacheReplPolicy::PERFECT)
+        return false;
+
+    cset_t& s = get_set(addr);
+    auto it = std::find_if(s.begin(), s.end(),
+                    [addr] (entry_t& e)
+                    {
+                        return e.valid && e.address == addr;
+                    });
+    if (it == s.end() || !it->prefetched)
+        return false;
+    it->prefetched = false;
+    return true;
+}
+
+__TEMPLATE_HEADER__ bool
+__TEMPLATE_CLASS__::clear_dirty(uint64_t addr)
+{
+    if constexpr (POL == CacheReplPolicy::PERFECT)
+        return false;
+
+    cset_t& s = get_set(addr);
+    auto it = std::find_if(s.begin(), s.end(),
+                    [addr] (entry_t& e)
+                    {
+                        return e.valid && e.address == addr;
+                    });
+    if (it == s.end() || !it->dirty)
+        return false;
+    it->dirty = false;
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
 __TEMPLATE_HEADER__ typename __TEMPLATE_CLASS__::fill_result_t
-__TEMPLATE_CLASS__::fill(uint64_t addr, size_t num_refs)
+__TEMPLATE_CLASS__::fill(uint64_t addr, size_t num_refs, CachePrefetcher pf, uint64_t ip, uint8_t coreid)
 {
-    return fill(entry_t(addr, num_refs));
+    return fill(entry_t(addr, num_refs, pf, ip, coreid));
 }
 
 __TEMPLATE_HEADER__ typename __TEMPLATE_CLASS__::fill_result_t
@@ -82,7 +152,11 @@ __TEMPLATE_CLASS__::fill(entry_t&& e)
     if (it == s.end()) {
         it = find_victim(s); 
         out = *it;
+        if constexpr (POL == CacheReplPolicy::SHIP)
+            ship_.on_evict(it->ip, it->reused);
     }
+    if constexpr (POL != CacheReplPolicy::LRU && POL != CacheReplPolicy::RAND && POL != CacheReplPolicy::SRRIP)
+        insert(s, e);
     *it = std::move(e);
     return out;
 }
@@ -102,6 +176,24 @@ __TEMPLATE_CLASS__::invalidate(uint64_t addr)
     it->valid = false;
 }
 
+__TEMPLATE_HEADER__ bool
+__TEMPLATE_CLASS__::remove(uint64_t addr)
+{
+    if constexpr (POL == CacheReplPolicy::PERFECT)
+        return false;
+
+    cset_t& s = get_set(addr);
+    auto it = std::find_if(s.begin(), s.end(),
+                    [addr] (entry_t& e)
+                    {
+                        return e.valid && e.address == addr;
+                    });
+    if (it == s.end())
+        return false;
+    it->valid = false;
+    return it->dirty;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
@@ -137,7 +229,7 @@ __TEMPLATE_CLASS__::find_victim(cset_t& s)
                                 });
     } else if constexpr (POL == CacheReplPolicy::RAND) {
         return std::next( s.begin(), fast_mod<WAYS>(rng_()) );
-    } else if constexpr (POL == CacheReplPolicy::SRRIP) {
+    } else if constexpr (IS_RRIP) {
         auto v_it = std::min_element(s.begin(), s.end(),
                                 [] (const entry_t& x, const entry_t& y)
                                 {
@@ -149,6 +241,21 @@ __TEMPLATE_CLASS__::find_victim(cset_t& s)
                 x.rrpv -= v_it->rrpv;
         }
         return v_it;
+    } else if constexpr (POL == CacheReplPolicy::HAWKEYE) {
+        // Averse lines have the lowest priority. Lines are aged on insertion (see `insert`),
+        // but aging stops above the averse lines, so ties are broken by LRU.
+        auto v_it = std::min_element(s.begin(), s.end(),
+                                [] (const entry_t& x, const entry_t& y)
+                                {
+                                    return x.rrpv < y.rrpv
+                                            || (x.rrpv == y.rrpv && x.timestamp < y.timestamp);
+                                });
+        // Only detrain in the sampled sets: OPTgen only trains there, so detraining in
+        // every set would outweigh it (by `SETS/HAWKEYE_SAMPLED_SETS`), and make almost
+        // every instruction averse.
+        if (v_it->rrpv > 0 && v_it->ip != 0 && hawkeye_sample_index(v_it->address) < HAWKEYE_SAMPLED_SETS)
+            hawkeye_.detrain(v_it->ip);
+        return v_it;
     } else {
         std::cerr << "unsupported cache replacement policy.\n";
         exit(1);
@@ -159,10 +266,50 @@ __TEMPLATE_CLASS__::find_victim(cset_t& s)
 ////////////////////////////////////////////////////////////////////////////
 
 __TEMPLATE_HEADER__ void
-__TEMPLATE_CLASS__::update(entry_t& e)
+__TEMPLATE_CLASS__::update(entry_t& e, uint64_t ip)
 {
     e.timestamp = GL_CYCLE;
-    e.rrpv = SRRIP_MAX;
+    if constexpr (POL == CacheReplPolicy::HAWKEYE) {
+        // A hit without an instruction address keeps the line's priority.
+        if (ip != 0) {
+            e.ip = ip;
+            e.rrpv = hawkeye_.is_friendly(ip) ? SRRIP_MAX : 0;
+        }
+    } else {
+        e.rrpv = SRRIP_MAX;
+    }
+    if constexpr (POL == CacheReplPolicy::SHIP) {
+        e.reused = true;
+        ship_.on_hit(e.ip);
+    }
+}
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::insert(cset_t& s, entry_t& e)
+{
+    if constexpr (POL == CacheReplPolicy::SHIP) {
+        e.rrpv = ship_.predict_reuse(e.ip) ? 1 : 0;
+    } else if constexpr (POL == CacheReplPolicy::HAWKEYE) {
+        // Lines filled without an instruction address (prefetches and page walks) have no
+        // prediction: they are kept over averse lines, but are the first friendly lines
+        // to be evicted.
+        if (e.ip == 0) {
+            e.rrpv = 1;
+        } else if (hawkeye_.is_friendly(e.ip)) {
+            // Age the other friendly lines (but keep them above averse lines).
+            for (entry_t& x : s) {
+                if (x.valid && x.rrpv > 1)
+                    --x.rrpv;
+            }
+            e.rrpv = SRRIP_MAX;
+        } else {
+            e.rrpv = 0;
+        }
+    } else if constexpr (POL == CacheReplPolicy::DRRIP || POL == CacheReplPolicy::TA_DRRIP) {
+        size_t d = (POL == CacheReplPolicy::TA_DRRIP) ? e.coreid : 0;
+        if (drrip_.fill_uses_brrip(fast_mod<SETS>(e.address), d))
+            e.rrpv = fast_mod<BRRIP_EPSILON>(rng_()) == 0 ? 1 : 0;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -9,11 +9,16 @@
 #include "constants.h"
 
 #include "cache.h"
+#include "cache/prefetch.h"
+#include "instruction.h"
 #include "io_bus.h"
 #include "transaction.h"
 #include "util/stats.h"
 
+#include <array>
+#include <limits>
 #include <memory>
+#include <type_traits>
 #include <unordered_map>
 
 ////////////////////////////////////////////////////////////////////////////
@@ -23,6 +28,10 @@ struct MSHREntry
 {
     bool is_fired =false;
     bool is_for_write_allocate;
+    /*
+     * Set if the entry is for a prefetch: the line is only filled into the cache.
+     * */
+    bool is_prefetch =false;
     Transaction trans;
 
     uint64_t cycle_fired;
@@ -34,6 +43,51 @@ struct MSHREntry
     {}
 };
 
+/*
+ * A core's stats in a cache (see `CacheControl::stats_for_core`). `blocking_writes`,
+ * `writebacks` and `pf_useless` are not per-core, so they are the cache's totals.
+ * */
+struct CacheCoreStats
+{
+    uint64_t accesses =0;
+    uint64_t misses =0;
+    uint64_t tot_penalty =0;
+    uint64_t num_penalty =0;
+    uint64_t invalidates =0;
+    uint64_t write_alloc =0;
+    uint64_t blocking_writes =0;
+    uint64_t writebacks =0;
+    uint64_t pf_requested =0;
+    uint64_t pf_dropped =0;
+    uint64_t pf_issued =0;
+    uint64_t pf_useful =0;
+    uint64_t pf_late =0;
+    uint64_t pf_useless =0;
+    uint64_t pf_pollution =0;
+    uint64_t pf_meta_accesses =0;
+
+    inline CacheCoreStats& operator+=(const CacheCoreStats& x)
+    {
+        accesses += x.accesses;
+        misses += x.misses;
+        tot_penalty += x.tot_penalty;
+        num_penalty += x.num_penalty;
+        invalidates += x.invalidates;
+        write_alloc += x.write_alloc;
+        blocking_writes += x.blocking_writes;
+        writebacks += x.writebacks;
+        pf_requested += x.pf_requested;
+        pf_dropped += x.pf_dropped;
+        pf_issued += x.pf_issued;
+        pf_useful += x.pf_useful;
+        pf_late += x.pf_late;
+        pf_useless += x.pf_useless;
+        pf_pollution += x.pf_pollution;
+        pf_meta_accesses += x.pf_meta_accesses;
+        return *this;
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 /*
@@ -44,10 +98,18 @@ struct MSHREntry
  *      (4) `NEXT_IS_INVALIDATE_ON_HIT`
  *      (5) `NUM_RW_PORTS`
  *      (6) `CACHE_LATENCY`
+ *      (7) `PREFETCH_DEGREE`
+ *      (8) `PREFETCH_TO_NEXT_LEVEL` (whether prefetches are filled into `NEXT_CONTROL`)
+ *      (9) `PREFETCH_METADATA_WAYS` (ways of the cache taken by prefetcher metadata,
+ *          which are not part of `CACHE`)
  *  Each setting determines how `CacheControl` operates `CACHE`
  *  and `NEXT_CONTROL`.
+ *
+ * `PREFETCHER` observes demand accesses and fills (see `NoPrefetcher`). Prefetches
+ * wait in `io_`'s prefetch queue (or `NEXT_CONTROL`'s), and are sent to the next
+ * level as reads if they miss. Accesses to prefetcher metadata take cache ports.
  * */
-template <class IMPL, class CACHE, class NEXT_CONTROL>
+template <class IMPL, class CACHE, class NEXT_CONTROL, class PREFETCHER=NoPrefetcher>
 class CacheControl
 {
 public:
@@ -66,14 +128,45 @@ public:
     stat_t s_num_penalty_{};
     stat_t s_invalidates_{};
     stat_t s_write_alloc_{};
+    /*
+     * Prefetch stats:
+     *  `s_pf_requested_`: prefetches accepted into a prefetch queue.
+     *  `s_pf_dropped_`: prefetches dropped as the prefetch queue was full.
+     *  `s_pf_issued_`: prefetches that missed (and were sent to the next level).
+     *  `s_pf_useful_`: demand hits to a prefetched line (only the first hit counts).
+     *  `s_pf_late_`: demand misses that merged with an in-flight prefetch.
+     *  `s_pf_pollution_`: demand misses to a line that was evicted by a prefetch.
+     * The first three are counted where the prefetch is issued, and the rest are counted
+     * where the line is filled.
+     * */
+    stat_t s_pf_requested_{};
+    stat_t s_pf_dropped_{};
+    stat_t s_pf_issued_{};
+    stat_t s_pf_useful_{};
+    stat_t s_pf_late_{};
+    stat_t s_pf_pollution_{};
+    stat_t s_pf_meta_accesses_{};
 
     uint64_t s_writebacks_ =0;
+    /*
+     * Prefetched lines that were evicted before any demand access.
+     * */
+    uint64_t s_pf_useless_ =0;
 
     const std::string cache_name_;
 private:
     using mshr_t = std::unordered_multimap<uint64_t, MSHREntry>;
     using wb_queue_t = std::deque<uint64_t>;
 
+    constexpr static bool HAS_PREFETCHER = !std::is_same<PREFETCHER, NoPrefetcher>::value;
+    /*
+     * The pollution filter is a direct-mapped array of tags of lines evicted by prefetch
+     * fills (Srinath et al., HPCA 2007).
+     * */
+    constexpr static size_t POLLUTION_FILTER_SIZE = 1024;
+
+    using pollution_filter_t = std::array<uint64_t, POLLUTION_FILTER_SIZE>;
+
     next_ptr& next_;
     /*
      * MSHR space is split between `mshr_` and `writeback_queue_`. Note that
@@ -81,26 +174,60 @@ private:
      * */
     mshr_t     mshr_;
     wb_queue_t writeback_queue_;
+
+    PREFETCHER      pf_;
+    prefetch_list_t pf_buf_;
+    /*
+     * Number of cache ports that are still needed for prefetcher metadata accesses.
+     * */
+    size_t pf_meta_pending_ =0;
+
+    pollution_filter_t pollution_filter_;
 public:
     CacheControl(std::string cache_name, next_ptr&);
 
-    void warmup_access(uint64_t, bool write);
+    /*
+     * `ip` is the instruction address of the access (or 0 if unknown).
+     * */
+    void warmup_access(uint64_t, bool write, uint64_t ip=0, uint8_t coreid=0);
+    /*
+     * Installs a line evicted from the previous level during warmup (only used if
+     * the previous level is `NEXT_IS_INVALIDATE_ON_HIT`).
+     * */
+    inline void warmup_fill(uint64_t address, uint64_t ip=0, uint8_t coreid=0)
+    {
+        cache_->fill(address, 1, CachePrefetcher::NONE, ip, coreid);
+    }
 
     void tick(void);
     void mark_load_as_done(uint64_t address);
     /*
      * Only use `is_dirty` if installing to an `INVALIDATE_ON_HIT` cache.
+     * `pf` tags the line as prefetched (see `CacheEntry`), and `ip` and `coreid` are the
+     * instruction address and core that filled the line.
      * */
-    void demand_fill(uint64_t address, size_t refcnt, bool is_dirty=false);
+    void demand_fill(uint64_t address, 
+                        size_t refcnt,
+                        bool is_dirty=false,
+                        CachePrefetcher pf=CachePrefetcher::NONE,
+                        uint64_t ip=0,
+                        uint8_t coreid=0);
     /*
      * Searches for an instruction in this cache. If it is found, a message
      * is printed to `stderr` and this function returns true.
      * */
     bool deadlock_find_inst(const iptr_t& inst);
+
+    CacheCoreStats stats_for_core(uint8_t coreid) const;
 private:
     void next_access(void);
     void handle_hit(const Transaction&);
     void handle_miss(const Transaction&, bool write_miss=false);
+    void handle_prefetch(const Transaction&);
+    /*
+     * Trains the prefetcher on a demand access and enqueues its prefetches.
+     * */
+    void train_prefetcher(const Transaction&, bool hit);
 
     inline bool do_writeback(uint64_t addr)
     {
@@ -111,6 +238,12 @@ private:
             return false;
     }
 
+    inline static uint64_t access_ip(const Transaction& t)
+    {
+        const iptr_t& inst = t.inst_list.front();
+        return inst == nullptr ? 0 : inst->ip;
+    }
+
     inline size_t curr_mshr_size(void)
     {
         return mshr_.size() + writeback_queue_.size();
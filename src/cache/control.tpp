@@ -3,8 +3,8 @@
  *  date:   4 December 2024
  * */
 
-#define __TEMPLATE_HEADER__ template <class IMPL, class CACHE, class NEXT_CONTROL>
-#define __TEMPLATE_CLASS__ CacheControl<IMPL, CACHE, NEXT_CONTROL>
+#define __TEMPLATE_HEADER__ template <class IMPL, class CACHE, class NEXT_CONTROL, class PREFETCHER>
+#define __TEMPLATE_CLASS__ CacheControl<IMPL, CACHE, NEXT_CONTROL, PREFETCHER>
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -14,46 +14,48 @@ __TEMPLATE_CLASS__::CacheControl(std::string cache_name, next_ptr& n)
     :cache_(new CACHE),
     io_(new IOBus(IMPL::RQ_SIZE, IMPL::WQ_SIZE, IMPL::PQ_SIZE)),
     cache_name_(cache_name),
-    next_(n)
+    next_(n),
+    pf_(IMPL::PREFETCH_DEGREE)
 {
     mshr_.reserve(IMPL::NUM_MSHR);
+    pollution_filter_.fill(std::numeric_limits<uint64_t>::max());
 }
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
 __TEMPLATE_HEADER__ void
-__TEMPLATE_CLASS__::warmup_access(uint64_t addr, bool write)
+__TEMPLATE_CLASS__::warmup_access(uint64_t addr, bool write, uint64_t ip, uint8_t coreid)
 {
     // If the cache is not write-allocate, then writes are pretty easy to handle.
     bool hit;
     if (write) {
         if (IMPL::WRITE_ALLOCATE) {
-            hit = cache_->probe(addr, true);
+            hit = cache_->probe(addr, true, ip);
         } else {
             cache_->mark_dirty(addr);
             return;
         }
     } else {
-        hit = cache_->probe(addr);
+        hit = cache_->probe(addr, false, ip);
     }
     if (hit) {
         if constexpr (IMPL::INVALIDATE_ON_HIT)
             cache_->invalidate(addr);
     } else {
         // Handle miss.
-        next_->warmup_access(addr, false);
+        next_->warmup_access(addr, false, ip, coreid);
         // Do fill.
         if constexpr (!IMPL::INVALIDATE_ON_HIT) {
-            auto res = cache_->fill(addr, 1);
+            auto res = cache_->fill(addr, 1, CachePrefetcher::NONE, ip, coreid);
             if constexpr (IMPL::WRITE_ALLOCATE)
                 cache_->mark_dirty(addr);
             if (res.has_value()) {
                 CacheEntry& e = res.value();
                 if constexpr (IMPL::NEXT_IS_INVALIDATE_ON_HIT)
-                    next_->cache_->fill(e.address, 1);
+                    next_->warmup_fill(e.address, e.ip, e.coreid);
                 if (e.dirty)
-                    next_->warmup_access(e.address, true);
+                    next_->warmup_access(e.address, true, 0, e.coreid);
             }
         }
     }
@@ -79,9 +81,14 @@ __TEMPLATE_CLASS__::tick()
         if (do_writeback(addr))
             writeback_queue_.pop_front();
     }
-    // Now perform cache accesses.
-    for (size_t i = 0; i < IMPL::NUM_RW_PORTS; i++)
+    // Now perform cache accesses. Prefetcher metadata accesses take ports first.
+    for (size_t i = 0; i < IMPL::NUM_RW_PORTS; i++) {
+        if (pf_meta_pending_ > 0) {
+            --pf_meta_pending_;
+            continue;
+        }
         next_access();
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -96,6 +103,14 @@ __TEMPLATE_CLASS__::mark_load_as_done(uint64_t address)
     }
     // First, fill the entry into the cache.
     auto [begin, end] = mshr_.equal_range(address);
+    bool is_prefetch = std::all_of(begin, end, [] (const auto& x) { return x.second.is_prefetch; });
+    CachePrefetcher pf_source = is_prefetch ? begin->second.trans.pf_source : CachePrefetcher::NONE;
+    // The fill is attributed to the first demand access.
+    auto demand_it = std::find_if(begin, end, [] (const auto& x) { return !x.second.is_prefetch; });
+    uint64_t ip = demand_it == end ? 0 : access_ip(demand_it->second.trans);
+    uint8_t coreid = begin->second.trans.coreid;
+    if constexpr (HAS_PREFETCHER)
+        pf_.on_fill(address, is_prefetch);
     if constexpr (!IMPL::INVALIDATE_ON_HIT) {
         size_t refcnt = std::transform_reduce(begin, end, static_cast<size_t>(0),
                                     std::plus<size_t>{},
@@ -104,11 +119,13 @@ __TEMPLATE_CLASS__::mark_load_as_done(uint64_t address)
                                         const MSHREntry& e = x.second;
                                         return e.trans.inst_list.size();
                                     });
-        demand_fill(address, refcnt);
+        demand_fill(address, refcnt, false, pf_source, ip, coreid);
     }
     // Now handle MSHR
     for (auto it = begin; it != end; it++) {
         const MSHREntry& e = it->second;
+        if (e.is_prefetch)
+            continue;
         if (e.is_for_write_allocate) {
             cache_->mark_dirty(e.trans.address);
             ++s_write_alloc_[e.trans.coreid];
@@ -125,9 +142,14 @@ __TEMPLATE_CLASS__::mark_load_as_done(uint64_t address)
 ////////////////////////////////////////////////////////////////////////////
 
 __TEMPLATE_HEADER__ void
-__TEMPLATE_CLASS__::demand_fill(uint64_t address, size_t refcnt, bool dirty)
+__TEMPLATE_CLASS__::demand_fill(uint64_t address,
+                                size_t refcnt,
+                                bool dirty,
+                                CachePrefetcher pf,
+                                uint64_t ip,
+                                uint8_t coreid)
 {
-    auto fill_res = cache_->fill(address, refcnt);
+    auto fill_res = cache_->fill(address, refcnt, pf, ip, coreid);
     if (dirty)
         cache_->mark_dirty(address);
     if (fill_res.has_value()) {
@@ -135,9 +157,13 @@ __TEMPLATE_CLASS__::demand_fill(uint64_t address, size_t refcnt, bool dirty)
         CacheEntry& e = fill_res.value();
         if (e.dirty)
             ++s_writebacks_;
+        if (e.prefetched)
+            ++s_pf_useless_;
+        if (pf != CachePrefetcher::NONE)
+            pollution_filter_[fast_mod<POLLUTION_FILTER_SIZE>(e.address)] = e.address;
         // Install into the next level of the cache.
         if constexpr (IMPL::NEXT_IS_INVALIDATE_ON_HIT)
-            next_->demand_fill(e.address, 1, e.dirty);
+            next_->demand_fill(e.address, 1, e.dirty, e.prefetched ? e.pf_source : CachePrefetcher::NONE, e.ip, e.coreid);
         else if (e.dirty && !do_writeback(e.address))
             writeback_queue_.push_back(e.address);
     }
@@ -176,6 +202,32 @@ __TEMPLATE_CLASS__::deadlock_find_inst(const iptr_t& inst)
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
+__TEMPLATE_HEADER__ CacheCoreStats
+__TEMPLATE_CLASS__::stats_for_core(uint8_t coreid) const
+{
+    CacheCoreStats st;
+    st.accesses = s_accesses_.at(coreid);
+    st.misses = s_misses_.at(coreid);
+    st.tot_penalty = s_tot_penalty_.at(coreid);
+    st.num_penalty = s_num_penalty_.at(coreid);
+    st.invalidates = s_invalidates_.at(coreid);
+    st.write_alloc = s_write_alloc_.at(coreid);
+    st.blocking_writes = io_->s_blocking_writes_;
+    st.writebacks = s_writebacks_;
+    st.pf_requested = s_pf_requested_.at(coreid);
+    st.pf_dropped = s_pf_dropped_.at(coreid);
+    st.pf_issued = s_pf_issued_.at(coreid);
+    st.pf_useful = s_pf_useful_.at(coreid);
+    st.pf_late = s_pf_late_.at(coreid);
+    st.pf_useless = s_pf_useless_;
+    st.pf_pollution = s_pf_pollution_.at(coreid);
+    st.pf_meta_accesses = s_pf_meta_accesses_.at(coreid);
+    return st;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
 __TEMPLATE_HEADER__ void
 __TEMPLATE_CLASS__::next_access()
 {
@@ -187,21 +239,29 @@ __TEMPLATE_CLASS__::next_access()
     if (!tt.has_value())
         return;
     Transaction& t = tt.value();
-    if (trans_is_read(t.type)) {
+    if (t.type == TransactionType::PREFETCH) {
+        handle_prefetch(t);
+    } else if (trans_is_read(t.type)) {
         // Probe the cache
         ++s_accesses_[t.coreid];
-        if (cache_->probe(t.address))
+        bool hit = cache_->probe(t.address, false, access_ip(t));
+        if (hit)
             handle_hit(t);
         else
             handle_miss(t);
+        train_prefetcher(t, hit);
     } else {
         // Mark the line in the cache as dirty. If `WRITE_ALLOCATE` is
         // specified (i.e. for the L1D$, then on a write miss, install
         // an MSHR entry).
         if constexpr (IMPL::WRITE_ALLOCATE) {
             ++s_accesses_[t.coreid];
-            if (!cache_->probe(t.address, true))
+            bool hit = cache_->probe(t.address, true, access_ip(t));
+            if (!hit)
                 handle_miss(t, true);
+            else if (cache_->clear_prefetched(t.address))
+                ++s_pf_useful_[t.coreid];
+            train_prefetcher(t, hit);
         } else {
             cache_->mark_dirty(t.address);
         }
@@ -214,6 +274,8 @@ __TEMPLATE_CLASS__::next_access()
 __TEMPLATE_HEADER__ void
 __TEMPLATE_CLASS__::handle_hit(const Transaction& t)
 {
+    if (cache_->clear_prefetched(t.address))
+        ++s_pf_useful_[t.coreid];
     // Update `io_`'s outgoing queue.
     io_->add_outgoing(t, IMPL::CACHE_LATENCY);
     if constexpr (IMPL::INVALIDATE_ON_HIT) {
@@ -227,15 +289,74 @@ __TEMPLATE_CLASS__::handle_miss(const Transaction& t, bool write_miss)
 {
     ++s_misses_[t.coreid];
 
+    uint64_t& pollution_tag = pollution_filter_[fast_mod<POLLUTION_FILTER_SIZE>(t.address)];
+    if (pollution_tag == t.address) {
+        ++s_pf_pollution_[t.coreid];
+        pollution_tag = std::numeric_limits<uint64_t>::max();
+    }
+    // If the first MSHR entry is for a prefetch, then no demand access is waiting yet.
+    auto mshr_it = mshr_.find(t.address);
+    if (mshr_it != mshr_.end() && mshr_it->second.is_prefetch)
+        ++s_pf_late_[t.coreid];
+
     MSHREntry e(t, write_miss);
 
     // Need to switch transaction type in case of write allocate.
     if (write_miss)
         e.trans.type = TransactionType::READ;
-    e.is_fired = mshr_.count(t.address) > 0 || next_->io_->add_incoming(e.trans);
+    e.is_fired = mshr_it != mshr_.end() || next_->io_->add_incoming(e.trans);
+    mshr_.insert({t.address, e});
+}
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::handle_prefetch(const Transaction& t)
+{
+    if (cache_->contains(t.address) || mshr_.count(t.address))
+        return;
+    ++s_pf_issued_[t.coreid];
+
+    MSHREntry e(t);
+    e.is_prefetch = true;
+    // The next level must return the line, so send it as a read.
+    e.trans.type = TransactionType::READ;
+    e.is_fired = next_->io_->add_incoming(e.trans);
     mshr_.insert({t.address, e});
 }
 
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::train_prefetcher(const Transaction& t, bool hit)
+{
+    if constexpr (HAS_PREFETCHER) {
+        if (t.type != TransactionType::READ && t.type != TransactionType::WRITE)
+            return;
+        // Limit the number of prefetches to the free space in the prefetch queue and MSHR.
+        size_t budget;
+        if constexpr (IMPL::PREFETCH_TO_NEXT_LEVEL)
+            budget = next_->io_->prefetch_queue_free();
+        else
+            budget = std::min(io_->prefetch_queue_free(), IMPL::NUM_MSHR - curr_mshr_size());
+        if (budget == 0)
+            return;
+        size_t meta_accesses = pf_.on_access(t.address, access_ip(t), hit, pf_buf_, budget);
+        s_pf_meta_accesses_[t.coreid] += meta_accesses;
+        pf_meta_pending_ += meta_accesses;
+        for (uint64_t addr : pf_buf_) {
+            Transaction pf(t.coreid, nullptr, TransactionType::PREFETCH, addr, t.address_is_ip);
+            pf.pf_source = PREFETCHER::TYPE;
+            bool accepted;
+            if constexpr (IMPL::PREFETCH_TO_NEXT_LEVEL)
+                accepted = next_->io_->add_incoming(pf);
+            else
+                accepted = io_->add_incoming(pf);
+            if (accepted)
+                ++s_pf_requested_[t.coreid];
+            else
+                ++s_pf_dropped_[t.coreid];
+        }
+        pf_buf_.clear();
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,137 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#include "cache/directory.h"
+#include "util/numerics.h"
+
+#include <algorithm>
+#include <limits>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+Directory::Directory(size_t sets, size_t ways)
+    :sets_(sets),
+    ways_(ways),
+    entries_(sets*ways)
+{
+    for (filter_t& f : invalidated_)
+        f.fill(std::numeric_limits<uint64_t>::max());
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+Directory::Action
+Directory::read(uint8_t coreid, uint64_t lineaddr)
+{
+    Action a;
+    Entry& e = get_entry(lineaddr, a);
+    const uint64_t bit = 1ull << coreid;
+    if (e.sharers & bit)
+        return a;
+    a.coherence_miss = take_invalidated(coreid, lineaddr);
+    // The owner keeps a copy, but loses the right to write it.
+    if (e.state == MESIState::E || e.state == MESIState::M) {
+        a.downgrade = e.sharers;
+        e.state = MESIState::S;
+    }
+    e.sharers |= bit;
+    if (e.state == MESIState::I)
+        e.state = MESIState::E;
+    return a;
+}
+
+Directory::Action
+Directory::write(uint8_t coreid, uint64_t lineaddr)
+{
+    Action a;
+    Entry& e = get_entry(lineaddr, a);
+    const uint64_t bit = 1ull << coreid;
+    // The owner can write without telling anyone.
+    if (e.sharers == bit && (e.state == MESIState::E || e.state == MESIState::M)) {
+        e.state = MESIState::M;
+        return a;
+    }
+    if (e.sharers & bit)
+        a.upgrade = true;
+    else
+        a.coherence_miss = take_invalidated(coreid, lineaddr);
+    a.invalidate = e.sharers & ~bit;
+    e.sharers = bit;
+    e.state = MESIState::M;
+    return a;
+}
+
+void
+Directory::mark_invalidated(uint8_t coreid, uint64_t lineaddr)
+{
+    invalidated_[coreid][fast_mod<INVALIDATION_FILTER_SIZE>(lineaddr)] = lineaddr;
+}
+
+void
+Directory::remove_sharer(uint8_t coreid, uint64_t lineaddr)
+{
+    auto begin = entries_.begin() + (lineaddr % sets_)*ways_;
+    auto it = std::find_if(begin, begin+ways_,
+                    [lineaddr] (const Entry& e)
+                    {
+                        return e.state != MESIState::I && e.lineaddr == lineaddr;
+                    });
+    if (it == begin+ways_)
+        return;
+    it->sharers &= ~(1ull << coreid);
+    if (it->sharers == 0)
+        it->state = MESIState::I;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+Directory::Entry&
+Directory::get_entry(uint64_t lineaddr, Action& a)
+{
+    auto begin = entries_.begin() + (lineaddr % sets_)*ways_,
+         end = begin+ways_;
+    ++time_;
+    auto it = std::find_if(begin, end,
+                    [lineaddr] (const Entry& e)
+                    {
+                        return e.state != MESIState::I && e.lineaddr == lineaddr;
+                    });
+    if (it == end) {
+        // Use a free entry if there is one (its timestamp is irrelevant), else the LRU entry.
+        it = std::min_element(begin, end,
+                    [] (const Entry& x, const Entry& y)
+                    {
+                        bool x_free = x.state == MESIState::I,
+                             y_free = y.state == MESIState::I;
+                        return x_free != y_free ? x_free : x.last_access < y.last_access;
+                    });
+        if (it->state != MESIState::I) {
+            a.evicted_line = it->lineaddr;
+            a.evicted_sharers = it->sharers;
+        }
+        *it = Entry{lineaddr, MESIState::I, 0, 0};
+    }
+    it->last_access = time_;
+    return *it;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+bool
+Directory::take_invalidated(uint8_t coreid, uint64_t lineaddr)
+{
+    uint64_t& tag = invalidated_[coreid][fast_mod<INVALIDATION_FILTER_SIZE>(lineaddr)];
+    if (tag != lineaddr)
+        return false;
+    tag = std::numeric_limits<uint64_t>::max();
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
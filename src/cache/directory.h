@@ -0,0 +1,123 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef CACHE_DIRECTORY_h
+#define CACHE_DIRECTORY_h
+
+#include "constants.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+enum class MESIState { I, S, E, M };
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * A MESI directory at the LLC, which tracks the private caches (L1d$ and L2$) of each
+ * core that hold a line. The state of a line is the state of its private copies: in `E`
+ * and `M`, there is exactly one sharer (the owner).
+ *
+ * `read` and `write` update the state of a line for an access by a core, and return the
+ * cores whose copies must be invalidated or downgraded to `S` (the caller does this, and
+ * writes back dirty data). Clean lines are evicted from the private caches silently, so a
+ * core may stay a sharer after it has evicted the line: the caller checks that a sharer
+ * still holds the line, and calls `remove_sharer` if it does not.
+ *
+ * The directory is sparse: it is set-associative (sized like the LLC), and only holds
+ * lines with at least one sharer. If a set is full, the least recently used entry is
+ * evicted, and its sharers must invalidate the line (see `Action`).
+ *
+ * A coherence miss is an access by a core to a line that was invalidated from its private
+ * caches by a write from another core. Each core has a direct-mapped filter of tags of
+ * invalidated lines (like the pollution filter in `CacheControl`) to detect these.
+ * */
+class Directory
+{
+public:
+    /*
+     * `invalidate` and `downgrade` are bitmasks of cores.
+     * */
+    struct Action
+    {
+        uint64_t invalidate =0;
+        uint64_t downgrade =0;
+        bool     coherence_miss =false;
+        /*
+         * Set if a write was to a line in `S` held by the writer.
+         * */
+        bool     upgrade =false;
+        /*
+         * Set if an entry was evicted to make room for the line: the evicted line, and the
+         * cores that must invalidate it.
+         * */
+        uint64_t evicted_line =0;
+        uint64_t evicted_sharers =0;
+    };
+private:
+    static_assert(NUM_THREADS <= 64, "the directory supports at most 64 cores");
+
+    constexpr static size_t INVALIDATION_FILTER_SIZE = 1024;
+
+    /*
+     * An entry is free if it is in `I`.
+     * */
+    struct Entry
+    {
+        uint64_t  lineaddr =0;
+        MESIState state =MESIState::I;
+        uint64_t  sharers =0;
+        uint64_t  last_access =0;
+    };
+
+    using filter_t = std::array<uint64_t, INVALIDATION_FILTER_SIZE>;
+
+    const size_t sets_;
+    const size_t ways_;
+    /*
+     * `sets_` sets of `ways_` entries.
+     * */
+    std::vector<Entry>                entries_;
+    std::array<filter_t, NUM_THREADS> invalidated_;
+    /*
+     * Number of lookups so far (used as the LRU timestamp).
+     * */
+    uint64_t time_ =0;
+public:
+    Directory(size_t sets, size_t ways);
+
+    Action read(uint8_t coreid, uint64_t lineaddr);
+    Action write(uint8_t coreid, uint64_t lineaddr);
+    /*
+     * Called if the copy of `lineaddr` in `coreid` was invalidated by a write from another
+     * core (so its next access to the line is a coherence miss).
+     * */
+    void mark_invalidated(uint8_t coreid, uint64_t lineaddr);
+    /*
+     * Called if `coreid` no longer holds `lineaddr`. The entry is freed once the line has
+     * no sharers.
+     * */
+    void remove_sharer(uint8_t coreid, uint64_t lineaddr);
+private:
+    /*
+     * Returns the entry for `lineaddr`, allocating it (in `I`) if there is none. If an
+     * entry must be evicted, this is recorded in `a`.
+     * */
+    Entry& get_entry(uint64_t lineaddr, Action& a);
+
+    /*
+     * Returns true if `lineaddr` was invalidated from `coreid` (and forgets it).
+     * */
+    bool take_invalidated(uint8_t coreid, uint64_t lineaddr);
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // CACHE_DIRECTORY_h
@@ -0,0 +1,94 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef CACHE_PREFETCH_h
+#define CACHE_PREFETCH_h
+
+#include "constants.h"
+#include "util/numerics.h"
+
+#include <cstdint>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * `NEXT_LINE`: prefetches the next `degree` lines after each access.
+ * `IP_STRIDE`: tracks the stride between accesses of each instruction, and prefetches
+ *              `degree` strides ahead once the stride repeats.
+ * `SPP`: Signature Path Prefetcher (Kim et al., MICRO 2016), a lookahead delta
+ *              prefetcher throttled by confidence (`degree` is unused).
+ * `TEMPORAL`: correlates consecutive misses of each instruction, and prefetches the
+ *              next `degree` lines of the chain. Its metadata takes ways of the cache.
+ * `FDIP`: not a cache prefetcher; tags the L1i$ prefetches sent by the complex core's
+ *              frontend (see `Core::fdip`).
+ *
+ * `NONE` must be first (it is the default value).
+ * */
+enum class CachePrefetcher { NONE, NEXT_LINE, IP_STRIDE, SPP, TEMPORAL, FDIP };
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Prefetchers write the line addresses they want to prefetch to a `prefetch_list_t`.
+ * */
+using prefetch_list_t = std::vector<uint64_t>;
+
+constexpr size_t LINES_PER_PAGE = PAGESIZE/LINESIZE;
+/*
+ * Prefetches do not cross page boundaries, as the next physical page is unrelated.
+ * */
+inline bool same_page(uint64_t x, uint64_t y)
+{
+    return (x >> numeric_traits<LINES_PER_PAGE>::log2) == (y >> numeric_traits<LINES_PER_PAGE>::log2);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Every prefetcher has the same interface as `NoPrefetcher`:
+ *  `on_access` is called on each demand access (with the instruction address,
+ *      or 0 if unknown), and may add up to `budget` prefetches to `out`. It returns
+ *      the number of accesses made to metadata stored in the cache, which take
+ *      cache ports.
+ *  `on_fill` is called when a line is filled into the cache.
+ * `TYPE` tags the prefetches (see `CacheEntry::pf_source`).
+ * */
+class NoPrefetcher
+{
+public:
+    constexpr static CachePrefetcher TYPE = CachePrefetcher::NONE;
+
+    NoPrefetcher(size_t degree) {}
+
+    inline size_t on_access(uint64_t line, uint64_t ip, bool hit, prefetch_list_t& out, size_t budget) { return 0; }
+    inline void on_fill(uint64_t line, bool is_prefetch) {}
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#include "cache/prefetch/ip_stride.h"
+#include "cache/prefetch/next_line.h"
+#include "cache/prefetch/spp.h"
+#include "cache/prefetch/temporal.h"
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+/*
+ * `META_LINES` is the number of cache lines reserved for prefetcher metadata.
+ * */
+template <CachePrefetcher P, size_t META_LINES=0> struct prefetcher_type { using type = NoPrefetcher; };
+
+template <size_t M> struct prefetcher_type<CachePrefetcher::NEXT_LINE, M> { using type = NextLinePrefetcher; };
+template <size_t M> struct prefetcher_type<CachePrefetcher::IP_STRIDE, M> { using type = IPStridePrefetcher; };
+template <size_t M> struct prefetcher_type<CachePrefetcher::SPP, M> { using type = SPPrefetcher; };
+template <size_t M> struct prefetcher_type<CachePrefetcher::TEMPORAL, M> { using type = TemporalPrefetcher<M>; };
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // CACHE_PREFETCH_h
@@ -0,0 +1,54 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#include "cache/prefetch.h"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+IPStridePrefetcher::IPStridePrefetcher(size_t degree)
+    :degree_(degree)
+{}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+IPStridePrefetcher::on_access(uint64_t line, uint64_t ip, bool hit, prefetch_list_t& out, size_t budget)
+{
+    Entry& e = table_[fast_mod<TABLE_SIZE>(ip ^ (ip >> 8))];
+    if (!e.valid || e.ip != ip) {
+        e = Entry{ip, line, 0, 0, true};
+        return 0;
+    }
+    int64_t stride = static_cast<int64_t>(line - e.last_line);
+    if (stride == 0)
+        return 0;
+    if (stride == e.stride) {
+        if (e.conf < CONF_MAX)
+            ++e.conf;
+    } else {
+        if (e.conf > 0)
+            --e.conf;
+        else
+            e.stride = stride;
+    }
+    e.last_line = line;
+
+    if (e.conf < CONF_THRESHOLD)
+        return 0;
+    for (size_t i = 1; i <= std::min(degree_, budget); i++) {
+        uint64_t pf_line = line + e.stride*static_cast<int64_t>(i);
+        if (!same_page(line, pf_line))
+            break;
+        out.push_back(pf_line);
+    }
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
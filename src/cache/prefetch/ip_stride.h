@@ -0,0 +1,53 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef CACHE_PREFETCH_IP_STRIDE_h
+#define CACHE_PREFETCH_IP_STRIDE_h
+
+#include "cache/prefetch.h"
+
+#include <array>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Direct-mapped table indexed by instruction address. Each entry holds the last
+ * line accessed by the instruction, the last stride, and a 2-bit confidence
+ * counter that is incremented when the stride repeats.
+ * */
+class IPStridePrefetcher
+{
+public:
+    constexpr static CachePrefetcher TYPE = CachePrefetcher::IP_STRIDE;
+
+    const size_t degree_;
+private:
+    constexpr static size_t  TABLE_SIZE = 256;
+    constexpr static uint8_t CONF_MAX = 3;
+    constexpr static uint8_t CONF_THRESHOLD = 2;
+
+    struct Entry
+    {
+        uint64_t ip;
+        uint64_t last_line;
+        int64_t  stride =0;
+        uint8_t  conf =0;
+        bool     valid =false;
+    };
+
+    using table_t = std::array<Entry, TABLE_SIZE>;
+
+    table_t table_{};
+public:
+    IPStridePrefetcher(size_t degree);
+
+    size_t on_access(uint64_t line, uint64_t ip, bool hit, prefetch_list_t& out, size_t budget);
+    inline void on_fill(uint64_t line, bool is_prefetch) {}
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // CACHE_PREFETCH_IP_STRIDE_h
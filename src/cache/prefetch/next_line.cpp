@@ -0,0 +1,32 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#include "cache/prefetch.h"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+NextLinePrefetcher::NextLinePrefetcher(size_t degree)
+    :degree_(degree)
+{}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+NextLinePrefetcher::on_access(uint64_t line, uint64_t ip, bool hit, prefetch_list_t& out, size_t budget)
+{
+    for (size_t i = 1; i <= std::min(degree_, budget); i++) {
+        if (!same_page(line, line+i))
+            break;
+        out.push_back(line+i);
+    }
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
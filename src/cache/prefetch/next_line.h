@@ -0,0 +1,30 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef CACHE_PREFETCH_NEXT_LINE_h
+#define CACHE_PREFETCH_NEXT_LINE_h
+
+#include "cache/prefetch.h"
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+class NextLinePrefetcher
+{
+public:
+    constexpr static CachePrefetcher TYPE = CachePrefetcher::NEXT_LINE;
+
+    const size_t degree_;
+
+    NextLinePrefetcher(size_t degree);
+
+    size_t on_access(uint64_t line, uint64_t ip, bool hit, prefetch_list_t& out, size_t budget);
+    inline void on_fill(uint64_t line, bool is_prefetch) {}
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // CACHE_PREFETCH_NEXT_LINE_h
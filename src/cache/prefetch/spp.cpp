@@ -0,0 +1,166 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#include "cache/prefetch.h"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+SPPrefetcher::SPPrefetcher(size_t degree) {}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+SPPrefetcher::on_access(uint64_t line, uint64_t ip, bool hit, prefetch_list_t& out, size_t budget)
+{
+    const uint64_t page = line >> numeric_traits<LINES_PER_PAGE>::log2;
+    const uint32_t offset = fast_mod<LINES_PER_PAGE>(line);
+
+    // Update the global accuracy if this line was prefetched.
+    FilterEntry& f = filter_[fast_mod<FILTER_SIZE>(line)];
+    if (f.valid && f.line == line && !f.useful) {
+        f.useful = true;
+        ++pf_useful_;
+    }
+
+    STEntry& e = st_[fast_mod<ST_SIZE>(page ^ (page >> 8))];
+    uint32_t sig;
+    if (e.valid && e.page == page) {
+        int32_t delta = static_cast<int32_t>(offset) - static_cast<int32_t>(e.last_offset);
+        if (delta == 0)
+            return 0;
+        update_pattern(e.sig, delta);
+        sig = next_sig(e.sig, delta);
+    } else {
+        sig = bootstrap_sig(offset);
+    }
+    e = STEntry{page, offset, sig, true};
+
+    if (sig != 0)
+        lookahead(line, sig, out, budget);
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+SPPrefetcher::update_pattern(uint32_t sig, int32_t delta)
+{
+    PTEntry& p = pt_[fast_mod<PT_SIZE>(sig)];
+    // Halve all counters when the signature counter saturates.
+    if (p.c_sig == COUNTER_MAX) {
+        p.c_sig >>= 1;
+        for (uint8_t& c : p.c_delta)
+            c >>= 1;
+    }
+    ++p.c_sig;
+
+    auto d_it = std::find(p.delta.begin(), p.delta.end(), delta);
+    size_t i;
+    if (d_it != p.delta.end() && p.c_delta[std::distance(p.delta.begin(), d_it)] > 0) {
+        i = std::distance(p.delta.begin(), d_it);
+    } else {
+        // Replace the delta with the lowest counter.
+        i = std::distance(p.c_delta.begin(), std::min_element(p.c_delta.begin(), p.c_delta.end()));
+        p.delta[i] = delta;
+        p.c_delta[i] = 0;
+    }
+    ++p.c_delta[i];
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+SPPrefetcher::lookahead(uint64_t line, uint32_t sig, prefetch_list_t& out, size_t budget)
+{
+    const double alpha = accuracy();
+    double conf = 1.0;
+    for (size_t d = 0; d < MAX_DEPTH && out.size() < budget; d++) {
+        const PTEntry& p = pt_[fast_mod<PT_SIZE>(sig)];
+        if (p.c_sig == 0)
+            return;
+        const uint32_t offset = fast_mod<LINES_PER_PAGE>(line);
+        // Prefetch every delta with enough confidence, and follow the most likely one.
+        size_t best = PT_DELTAS;
+        double best_conf = 0.0;
+        for (size_t i = 0; i < PT_DELTAS && out.size() < budget; i++) {
+            if (p.c_delta[i] == 0)
+                continue;
+            double c = conf * mean(p.c_delta[i], p.c_sig);
+            if (c < PF_THRESHOLD)
+                continue;
+            if (c > best_conf) {
+                best = i;
+                best_conf = c;
+            }
+            int64_t pf_offset = static_cast<int64_t>(offset) + p.delta[i];
+            if (pf_offset < 0 || pf_offset >= static_cast<int64_t>(LINES_PER_PAGE)) {
+                ghr_insert(sig, c, offset, p.delta[i]);
+                continue;
+            }
+            uint64_t pf_line = line + p.delta[i];
+            if (filter_insert(pf_line)) {
+                out.push_back(pf_line);
+                if (++pf_issued_ >= ACCURACY_WINDOW) {
+                    pf_issued_ >>= 1;
+                    pf_useful_ >>= 1;
+                }
+            }
+        }
+        if (best == PT_DELTAS)
+            return;
+        int64_t next_offset = static_cast<int64_t>(offset) + p.delta[best];
+        if (next_offset < 0 || next_offset >= static_cast<int64_t>(LINES_PER_PAGE))
+            return;
+        line += p.delta[best];
+        sig = next_sig(sig, p.delta[best]);
+        conf = alpha * best_conf;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+uint32_t
+SPPrefetcher::bootstrap_sig(uint32_t offset)
+{
+    const GHREntry* best = nullptr;
+    for (const GHREntry& g : ghr_) {
+        if (!g.valid)
+            continue;
+        // The path left the previous page at `last_offset + delta`: check where it
+        // lands in this page.
+        int64_t x = static_cast<int64_t>(g.last_offset) + g.delta;
+        uint32_t landing = static_cast<uint32_t>(fast_mod<LINES_PER_PAGE>(static_cast<uint64_t>(x)));
+        if (landing == offset && (best == nullptr || g.conf > best->conf))
+            best = &g;
+    }
+    return best == nullptr ? 0 : next_sig(best->sig, best->delta);
+}
+
+void
+SPPrefetcher::ghr_insert(uint32_t sig, double conf, uint32_t last_offset, int32_t delta)
+{
+    ghr_[ghr_next_] = GHREntry{sig, conf, last_offset, delta, true};
+    fast_increment_and_mod_inplace<GHR_SIZE>(ghr_next_);
+}
+
+bool
+SPPrefetcher::filter_insert(uint64_t line)
+{
+    FilterEntry& f = filter_[fast_mod<FILTER_SIZE>(line)];
+    if (f.valid && f.line == line)
+        return false;
+    f = FilterEntry{line, false, true};
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,134 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef CACHE_PREFETCH_SPP_h
+#define CACHE_PREFETCH_SPP_h
+
+#include "cache/prefetch.h"
+#include "util/stats.h"
+
+#include <array>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Signature Path Prefetcher (Kim et al., MICRO 2016).
+ *
+ * The signature table tracks the last offset and a signature (a hash of the last few
+ * deltas) of recently accessed pages. The pattern table maps a signature to the deltas
+ * that followed it, each with a counter. On an access, SPP walks the most likely path
+ * of deltas ahead of the access, multiplying the path confidence by the confidence of
+ * each delta (and by the global prefetch accuracy past the first step). Every delta
+ * with enough confidence is prefetched, and the walk stops when the path confidence
+ * drops below `PF_THRESHOLD` (or the budget is used up).
+ *
+ * If the walk crosses into another page, the signature is kept in the global history
+ * register, so the first access to the next page can continue the path.
+ *
+ * The prefetch filter drops duplicate prefetches, and tracks which prefetched lines
+ * were accessed to estimate the global accuracy.
+ * */
+class SPPrefetcher
+{
+    constexpr static size_t ST_SIZE = 256;
+    constexpr static size_t PT_SIZE = 512;
+    constexpr static size_t PT_DELTAS = 4;
+    constexpr static size_t GHR_SIZE = 8;
+    constexpr static size_t FILTER_SIZE = 1024;
+
+    constexpr static size_t   SIG_BITS = 12;
+    constexpr static size_t   SIG_SHIFT = 3;
+    constexpr static uint8_t  COUNTER_MAX = 15;
+    constexpr static size_t   MAX_DEPTH = 16;
+    constexpr static double   PF_THRESHOLD = 0.25;
+    /*
+     * Accuracy counts are halved once `ACCURACY_WINDOW` prefetches are issued.
+     * */
+    constexpr static uint64_t ACCURACY_WINDOW = 1024;
+
+    struct STEntry
+    {
+        uint64_t page;
+        uint32_t last_offset;
+        uint32_t sig;
+        bool     valid =false;
+    };
+
+    struct PTEntry
+    {
+        std::array<int32_t, PT_DELTAS> delta{};
+        std::array<uint8_t, PT_DELTAS> c_delta{};
+        uint8_t c_sig =0;
+    };
+
+    struct GHREntry
+    {
+        uint32_t sig;
+        double   conf;
+        uint32_t last_offset;
+        int32_t  delta;
+        bool     valid =false;
+    };
+
+    struct FilterEntry
+    {
+        uint64_t line;
+        bool     useful =false;
+        bool     valid =false;
+    };
+
+    std::array<STEntry, ST_SIZE>         st_{};
+    std::array<PTEntry, PT_SIZE>         pt_{};
+    std::array<GHREntry, GHR_SIZE>       ghr_{};
+    std::array<FilterEntry, FILTER_SIZE> filter_{};
+
+    size_t ghr_next_ =0;
+    /*
+     * For the global accuracy: number of prefetches issued, and the number of those
+     * that were accessed.
+     * */
+    uint64_t pf_issued_ =0;
+    uint64_t pf_useful_ =0;
+public:
+    constexpr static CachePrefetcher TYPE = CachePrefetcher::SPP;
+
+    SPPrefetcher(size_t degree);
+
+    size_t on_access(uint64_t line, uint64_t ip, bool hit, prefetch_list_t& out, size_t budget);
+    inline void on_fill(uint64_t line, bool is_prefetch) {}
+private:
+    void update_pattern(uint32_t sig, int32_t delta);
+    /*
+     * Follows the path from `sig` at `line`, and adds prefetches to `out`.
+     * */
+    void lookahead(uint64_t line, uint32_t sig, prefetch_list_t& out, size_t budget);
+    /*
+     * Returns the signature for a page whose first access is at `offset`, from
+     * a path in the global history register that crossed into it (or 0).
+     * */
+    uint32_t bootstrap_sig(uint32_t offset);
+    void     ghr_insert(uint32_t sig, double conf, uint32_t last_offset, int32_t delta);
+    /*
+     * Returns false if `line` was already prefetched recently.
+     * */
+    bool filter_insert(uint64_t line);
+
+    inline double accuracy(void) const
+    {
+        return pf_issued_ == 0 ? 1.0 : mean(pf_useful_, pf_issued_);
+    }
+
+    inline static uint32_t next_sig(uint32_t sig, int32_t delta)
+    {
+        // Deltas are sign-magnitude encoded in 7 bits.
+        uint32_t enc = (delta < 0) ? ((-delta) | (1 << 6)) : delta;
+        return ((sig << SIG_SHIFT) ^ enc) & ((1 << SIG_BITS)-1);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // CACHE_PREFETCH_SPP_h
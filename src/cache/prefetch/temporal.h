@@ -0,0 +1,91 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef CACHE_PREFETCH_TEMPORAL_h
+#define CACHE_PREFETCH_TEMPORAL_h
+
+#include "cache/prefetch.h"
+
+#include <array>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Temporal (address-correlating) prefetcher, similar to Triage (Wu et al., MICRO 2019).
+ *
+ * The training unit holds the last miss of each instruction. On a miss to `B` by an
+ * instruction whose last miss was `A`, the correlation `A -> B` is written to the
+ * metadata store. On a miss to `A`, the prefetcher follows the chain `A -> B -> ...`
+ * for up to `degree` lines. Unlike the spatial prefetchers, prefetches may cross pages.
+ *
+ * The metadata store takes `META_LINES` lines of the cache (the ways given by
+ * `prefetch_metadata_ways`), with `ENTRIES_PER_LINE` compressed correlations per line.
+ * Each line is a set, with LRU replacement. Every metadata read and write is returned
+ * from `on_access` as an access to the cache.
+ * */
+template <size_t META_LINES>
+class TemporalPrefetcher
+{
+public:
+    constexpr static CachePrefetcher TYPE = CachePrefetcher::TEMPORAL;
+
+    const size_t degree_;
+private:
+    constexpr static size_t TU_SIZE = 256;
+    constexpr static size_t ENTRIES_PER_LINE = 16;
+
+    struct TUEntry
+    {
+        uint64_t ip;
+        uint64_t last_line;
+        bool     valid =false;
+    };
+
+    struct MetaEntry
+    {
+        uint64_t line;
+        uint64_t next;
+        uint64_t timestamp =0;
+        bool     valid =false;
+    };
+
+    using tu_t = std::array<TUEntry, TU_SIZE>;
+    using meta_set_t = std::array<MetaEntry, ENTRIES_PER_LINE>;
+    using meta_t = std::vector<meta_set_t>;
+
+    tu_t   tu_{};
+    meta_t meta_;
+    /*
+     * Used for LRU timestamps in `meta_`.
+     * */
+    uint64_t meta_clock_ =0;
+public:
+    TemporalPrefetcher(size_t degree);
+
+    size_t on_access(uint64_t line, uint64_t ip, bool hit, prefetch_list_t& out, size_t budget);
+    inline void on_fill(uint64_t line, bool is_prefetch) {}
+private:
+    /*
+     * Returns the line that followed `line`, or `line` itself if there is no correlation.
+     * */
+    uint64_t meta_lookup(uint64_t line);
+    void     meta_update(uint64_t line, uint64_t next);
+
+    inline meta_set_t& get_meta_set(uint64_t line)
+    {
+        return meta_[fast_mod<META_LINES>(line ^ (line >> 16))];
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#include "cache/prefetch/temporal.tpp"
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // CACHE_PREFETCH_TEMPORAL_h
@@ -0,0 +1,87 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#include <algorithm>
+
+#define __TEMPLATE_HEADER__ template <size_t META_LINES>
+#define __TEMPLATE_CLASS__  TemporalPrefetcher<META_LINES>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__
+__TEMPLATE_CLASS__::TemporalPrefetcher(size_t degree)
+    :degree_(degree),
+    meta_(META_LINES)
+{}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ size_t
+__TEMPLATE_CLASS__::on_access(uint64_t line, uint64_t ip, bool hit, prefetch_list_t& out, size_t budget)
+{
+    // Only misses are correlated.
+    if (hit)
+        return 0;
+    size_t meta_accesses = 0;
+    // Train: record the correlation from the instruction's last miss.
+    TUEntry& e = tu_[fast_mod<TU_SIZE>(ip ^ (ip >> 8))];
+    if (e.valid && e.ip == ip && e.last_line != line) {
+        meta_update(e.last_line, line);
+        ++meta_accesses;
+    }
+    e = TUEntry{ip, line, true};
+    // Predict: follow the chain of correlations.
+    uint64_t curr = line;
+    for (size_t i = 0; i < std::min(degree_, budget); i++) {
+        uint64_t next = meta_lookup(curr);
+        ++meta_accesses;
+        if (next == curr || next == line)
+            break;
+        out.push_back(next);
+        curr = next;
+    }
+    return meta_accesses;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ uint64_t
+__TEMPLATE_CLASS__::meta_lookup(uint64_t line)
+{
+    meta_set_t& s = get_meta_set(line);
+    auto it = std::find_if(s.begin(), s.end(), [line] (const MetaEntry& x) { return x.valid && x.line == line; });
+    if (it == s.end())
+        return line;
+    it->timestamp = ++meta_clock_;
+    return it->next;
+}
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::meta_update(uint64_t line, uint64_t next)
+{
+    meta_set_t& s = get_meta_set(line);
+    auto it = std::find_if(s.begin(), s.end(), [line] (const MetaEntry& x) { return x.valid && x.line == line; });
+    if (it == s.end()) {
+        // Replace an invalid entry, or the LRU entry.
+        it = std::min_element(s.begin(), s.end(),
+                [] (const MetaEntry& x, const MetaEntry& y)
+                {
+                    return (x.valid ? x.timestamp : 0) < (y.valid ? y.timestamp : 0);
+                });
+    }
+    *it = MetaEntry{line, next, ++meta_clock_, true};
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#undef __TEMPLATE_HEADER__
+#undef __TEMPLATE_CLASS__
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
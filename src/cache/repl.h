@@ -0,0 +1,205 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef CACHE_REPL_h
+#define CACHE_REPL_h
+
+#include "util/numerics.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * State for replacement policies that need more than the per-entry metadata
+ * in `CacheEntry`. `Cache` only holds the state used by its policy (otherwise,
+ * it holds a `NoReplState`).
+ * */
+struct NoReplState {};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+inline uint64_t
+pc_signature(uint64_t ip)
+{
+    return ip ^ (ip >> 14) ^ (ip >> 28);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Set dueling for DRRIP (Jaleel et al., ISCA 2010): each duel has leader sets that
+ * always use SRRIP or BRRIP insertion, and a PSEL counter that is incremented on
+ * misses (fills) in SRRIP leaders and decremented on misses in BRRIP leaders. The
+ * follower sets use BRRIP if the PSEL counter is in its upper half.
+ *
+ * DRRIP has one duel. TA-DRRIP has one duel per core: each core has its own
+ * leader sets and PSEL counter, and fills by a core follow the core's duel.
+ * */
+template <size_t SETS, size_t NUM_DUELS>
+class DRRIPDueling
+{
+    constexpr static size_t   LEADERS = SETS/(2*NUM_DUELS) < 32 ? SETS/(2*NUM_DUELS) : 32;
+    constexpr static uint16_t PSEL_MAX = 1023;
+
+    static_assert(LEADERS > 0, "DRRIP needs at least two sets per duel");
+    /*
+     * Leader sets are spread over the cache: in every block of `PERIOD` sets, the
+     * `2d`-th set is an SRRIP leader for duel `d`, and the `2d+1`-th is a BRRIP leader.
+     * */
+    constexpr static size_t PERIOD = SETS/LEADERS;
+
+    std::array<uint16_t, NUM_DUELS> psel_;
+public:
+    DRRIPDueling(void)
+    {
+        psel_.fill(PSEL_MAX/2);
+    }
+    /*
+     * Called on a fill to `set` in duel `d`. Returns true if the fill should use
+     * BRRIP insertion.
+     * */
+    inline bool fill_uses_brrip(size_t set, size_t d)
+    {
+        size_t k = fast_mod<PERIOD>(set);
+        uint16_t& p = psel_[d];
+        if (k == 2*d) {
+            if (p < PSEL_MAX)
+                ++p;
+            return false;
+        } else if (k == 2*d+1) {
+            if (p > 0)
+                --p;
+            return true;
+        } else {
+            return p > PSEL_MAX/2;
+        }
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * SHiP-PC (Wu et al., MICRO 2011): the Signature History Counter Table has a
+ * counter per (hashed) instruction address that is incremented when a line filled
+ * by the instruction is reused, and decremented when such a line is evicted without
+ * reuse. Lines filled by instructions whose counter is 0 are inserted with the
+ * lowest priority.
+ * */
+class SHiPPredictor
+{
+    constexpr static size_t  SHCT_SIZE = 16384;
+    constexpr static uint8_t SHCT_MAX = 7;
+
+    std::array<uint8_t, SHCT_SIZE> shct_;
+public:
+    SHiPPredictor(void)
+    {
+        shct_.fill(1);
+    }
+
+    inline bool predict_reuse(uint64_t ip) const
+    {
+        return shct_[index(ip)] > 0;
+    }
+
+    inline void on_hit(uint64_t ip)
+    {
+        uint8_t& c = shct_[index(ip)];
+        if (c < SHCT_MAX)
+            ++c;
+    }
+
+    inline void on_evict(uint64_t ip, bool reused)
+    {
+        uint8_t& c = shct_[index(ip)];
+        if (!reused && c > 0)
+            --c;
+    }
+private:
+    inline static size_t index(uint64_t ip)
+    {
+        return fast_mod<SHCT_SIZE>(pc_signature(ip));
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Hawkeye (Jain and Lin, ISCA 2016): OPTgen replays the accesses to a few sampled
+ * sets to determine whether Belady's OPT would have cached each line, and trains a
+ * predictor of counters (indexed by the instruction that last accessed the line) with
+ * the result. Lines accessed by cache-friendly instructions are kept, and lines
+ * accessed by cache-averse instructions are evicted first.
+ *
+ * OPTgen keeps an occupancy vector over the last `HISTORY_LEN` accesses to each sampled
+ * set: a reuse hits under OPT if the occupancy between the two accesses is below `WAYS`.
+ * */
+template <size_t WAYS>
+class HawkeyePredictor
+{
+public:
+    constexpr static size_t HISTORY_LEN = 8*WAYS;
+private:
+    constexpr static size_t  PRED_SIZE = 8192;
+    constexpr static uint8_t PRED_MAX = 7;
+    constexpr static uint8_t PRED_FRIENDLY_THRESHOLD = 4;
+
+    struct Slot
+    {
+        uint64_t line;
+        uint64_t ip;
+        uint8_t  occupancy =0;
+        bool     valid =false;
+        bool     reused =false;
+    };
+
+    struct OPTgen
+    {
+        std::array<Slot, HISTORY_LEN> slots{};
+        size_t time =0;
+    };
+
+    std::vector<OPTgen>             sampler_;
+    std::array<uint8_t, PRED_SIZE>  pred_;
+public:
+    HawkeyePredictor(size_t num_sampled_sets);
+    /*
+     * Called on each access to the `i`-th sampled set.
+     * */
+    void access(size_t i, uint64_t line, uint64_t ip);
+
+    inline bool is_friendly(uint64_t ip) const
+    {
+        return pred_[index(ip)] >= PRED_FRIENDLY_THRESHOLD;
+    }
+    /*
+     * Called when a friendly line is evicted, as OPT would not have evicted it.
+     * */
+    inline void detrain(uint64_t ip)
+    {
+        train(ip, false);
+    }
+private:
+    void train(uint64_t ip, bool friendly);
+
+    inline static size_t index(uint64_t ip)
+    {
+        return fast_mod<PRED_SIZE>(pc_signature(ip));
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#include "cache/repl.tpp"
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // CACHE_REPL_h
@@ -0,0 +1,72 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#include <algorithm>
+
+#define __TEMPLATE_HEADER__ template <size_t WAYS>
+#define __TEMPLATE_CLASS__  HawkeyePredictor<WAYS>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__
+__TEMPLATE_CLASS__::HawkeyePredictor(size_t num_sampled_sets)
+    :sampler_(num_sampled_sets)
+{
+    pred_.fill(PRED_FRIENDLY_THRESHOLD);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::access(size_t i, uint64_t line, uint64_t ip)
+{
+    OPTgen& g = sampler_[i];
+    const size_t t = g.time;
+    // Search for the last access to `line` in the window.
+    for (size_t k = 1; k < HISTORY_LEN && k <= t; k++) {
+        Slot& prev = g.slots[fast_mod<HISTORY_LEN>(t-k)];
+        if (!prev.valid || prev.line != line)
+            continue;
+        if (!prev.reused) {
+            prev.reused = true;
+            // OPT hits if there is space in every slot since the last access.
+            bool opt_hit = true;
+            for (size_t j = 1; j <= k && opt_hit; j++)
+                opt_hit = g.slots[fast_mod<HISTORY_LEN>(t-j)].occupancy < WAYS;
+            if (opt_hit) {
+                for (size_t j = 1; j <= k; j++)
+                    ++g.slots[fast_mod<HISTORY_LEN>(t-j)].occupancy;
+            }
+            train(prev.ip, opt_hit);
+        }
+        break;
+    }
+    g.slots[fast_mod<HISTORY_LEN>(t)] = Slot{line, ip, 0, true, false};
+    ++g.time;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::train(uint64_t ip, bool friendly)
+{
+    uint8_t& c = pred_[index(ip)];
+    if (friendly && c < PRED_MAX)
+        ++c;
+    else if (!friendly && c > 0)
+        --c;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#undef __TEMPLATE_HEADER__
+#undef __TEMPLATE_CLASS__
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,275 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef CACHE_SLICED_h
+#define CACHE_SLICED_h
+
+#include "constants.h"
+
+#include "cache/control.h"
+#include "interconnect.h"
+#include "io_bus.h"
+#include "transaction.h"
+#include "util/numerics.h"
+#include "util/stats.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Sits between the slices of a `SlicedCacheControl` and `NEXT` (memory) if there is an
+ * interconnect: transactions sent to `NEXT` by a slice are carried from the slice to
+ * the memory controller. The latency of each read is kept until its response (see
+ * `SlicedCacheControl::mark_load_as_done`).
+ * */
+template <class NEXT>
+class InterconnectPort
+{
+public:
+    using next_ptr = std::unique_ptr<NEXT>;
+    /*
+     * Returns the index of the slice that holds an address.
+     * */
+    using slice_index_fn_t = size_t (*)(uint64_t);
+
+    class IO
+    {
+        InterconnectPort* parent_;
+    public:
+        IO(InterconnectPort* p)
+            :parent_(p)
+        {}
+
+        bool add_incoming(Transaction t);
+    };
+
+    using io_ptr = std::unique_ptr<IO>;
+
+    io_ptr io_;
+private:
+    next_ptr&        next_;
+    Interconnect&    noc_;
+    slice_index_fn_t slice_index_;
+
+    std::unordered_map<uint64_t, uint64_t> read_latency_;
+public:
+    InterconnectPort(next_ptr& n, Interconnect& noc, slice_index_fn_t f)
+        :io_(new IO(this)),
+        next_(n),
+        noc_(noc),
+        slice_index_(f)
+    {}
+
+    inline void warmup_access(uint64_t addr, bool write, uint64_t ip=0, uint8_t coreid=0)
+    {
+        next_->warmup_access(addr, write, ip, coreid);
+    }
+    /*
+     * Returns the latency of the read to `address` from the slice to memory (and forgets it).
+     * */
+    uint64_t take_read_latency(uint64_t address);
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * A cache split into `N` slices (i.e., a NUCA LLC). Each slice is a `CacheControl`
+ * (`SLICE`) with its own queues, MSHRs and ports, and holds `1/N`-th of the sets.
+ * `SLICE_SETS` is the number of sets per slice. Lines are assigned to slices by a hash
+ * of the line address.
+ *
+ * If `NOC_TOPOLOGY` is `NONE`, cores and slices sit on a ring of `N` stops, with the cores
+ * spread evenly over the stops. A response from a slice is delayed by `HOP_LATENCY` cycles
+ * per hop in each direction between the slice and the requesting core.
+ *
+ * Otherwise, all traffic between the previous level, the slices and `NEXT` is carried by
+ * an `Interconnect`: requests and writebacks to a slice, responses from a slice (once they
+ * leave the slice), and requests, writebacks and fills between the slices and memory (via
+ * `InterconnectPort`). As the slices accept requests at once, the latency of a request is
+ * added to the latency of its response.
+ *
+ * `SlicedCacheControl` has the same interface as `CacheControl` for the previous level
+ * and the memory system: `io_` routes incoming transactions to the slices, and collects
+ * the slices' outgoing transactions.
+ * */
+template <class SLICE, class NEXT, size_t N, size_t SLICE_SETS, size_t HOP_LATENCY>
+class SlicedCacheControl
+{
+public:
+    constexpr static size_t NUM_SLICES = N;
+
+    constexpr static size_t CACHE_LATENCY = SLICE::CACHE_LATENCY;
+    constexpr static size_t NUM_RW_PORTS = SLICE::NUM_RW_PORTS;
+
+    constexpr static bool HAS_NOC = NOC_TOPOLOGY != NOCTopology::NONE;
+
+    using slice_ptr = std::unique_ptr<SLICE>;
+    using slice_array_t = std::array<slice_ptr, N>;
+    using next_ptr = std::unique_ptr<NEXT>;
+    using noc_ptr = std::unique_ptr<Interconnect>;
+    using port_ptr = std::unique_ptr<InterconnectPort<NEXT>>;
+
+    class Router
+    {
+    public:
+        /*
+         * Responses from all slices, once the hop (or interconnect) latency is added.
+         * */
+        IOBus::out_queue_t outgoing_queue_;
+    private:
+        SlicedCacheControl* parent_;
+    public:
+        Router(SlicedCacheControl* p)
+            :parent_(p)
+        {}
+
+        bool add_incoming(Transaction t);
+        /*
+         * As a prefetch may go to any slice, this is the minimum over all slices.
+         * */
+        size_t prefetch_queue_free(void) const;
+    };
+
+    using io_ptr = std::unique_ptr<Router>;
+
+    slice_array_t slices_;
+    io_ptr        io_;
+    /*
+     * Both are null if `NOC_TOPOLOGY` is `NONE`.
+     * */
+    noc_ptr       noc_;
+    port_ptr      port_;
+
+    VecStat<uint64_t, N> s_slice_accesses_{};
+
+    const std::string cache_name_;
+private:
+    constexpr static size_t SET_BITS = numeric_traits<SLICE_SETS>::log2;
+    /*
+     * Fills from memory that are still in the interconnect: (1) the cycle they arrive,
+     * and (2) the address.
+     * */
+    using fill_t = std::pair<uint64_t, uint64_t>;
+    using fill_queue_t = std::priority_queue<fill_t, std::vector<fill_t>, std::greater<fill_t>>;
+
+    fill_queue_t pending_fills_;
+public:
+    SlicedCacheControl(std::string cache_name, next_ptr&);
+
+    inline void warmup_access(uint64_t addr, bool write, uint64_t ip=0, uint8_t coreid=0)
+    {
+        get_slice(addr)->warmup_access(addr, write, ip, coreid);
+    }
+
+    inline void warmup_fill(uint64_t addr, uint64_t ip=0, uint8_t coreid=0)
+    {
+        get_slice(addr)->warmup_fill(addr, ip, coreid);
+    }
+
+    void tick(void);
+    void mark_load_as_done(uint64_t address);
+
+    inline void demand_fill(uint64_t address,
+                            size_t refcnt,
+                            bool is_dirty=false,
+                            CachePrefetcher pf=CachePrefetcher::NONE,
+                            uint64_t ip=0,
+                            uint8_t coreid=0)
+    {
+        get_slice(address)->demand_fill(address, refcnt, is_dirty, pf, ip, coreid);
+    }
+
+    bool deadlock_find_inst(const iptr_t& inst);
+    /*
+     * Returns the core's stats summed over the slices.
+     * */
+    CacheCoreStats stats_for_core(uint8_t coreid) const;
+
+    void print_stats(std::ostream&);
+
+    inline slice_ptr& get_slice(uint64_t address)
+    {
+        return slices_[slice_index(address)];
+    }
+    /*
+     * The low bits of the address index the set in the slice, so the hash folds in
+     * the higher bits (otherwise, each slice would only use `1/N`-th of its sets).
+     * */
+    inline static size_t slice_index(uint64_t address)
+    {
+        return fast_mod<N>(address ^ (address >> SET_BITS) ^ (address >> 2*SET_BITS));
+    }
+private:
+    /*
+     * Moves responses from the slice's outgoing queue into `io_`'s.
+     * */
+    void collect_outgoing(size_t slice_idx);
+
+    inline static uint64_t hop_latency(uint8_t coreid, size_t slice_idx)
+    {
+        size_t stop = (coreid * N) / NUM_THREADS;
+        size_t d = stop > slice_idx ? stop-slice_idx : slice_idx-stop;
+        size_t hops = std::min(d, N-d);
+        return 2*hops*HOP_LATENCY;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * `is_sliced_cache<T>::value` is true if `T` is a `SlicedCacheControl`.
+ * */
+template <class T, class=void>
+struct is_sliced_cache : std::false_type {};
+
+template <class T>
+struct is_sliced_cache<T, std::void_t<decltype(T::NUM_SLICES)>> : std::true_type {};
+/*
+ * Prints the stats of the slices and interconnect (if `CACHE` is sliced).
+ * */
+template <class CACHE> inline void
+print_slice_stats(const std::unique_ptr<CACHE>& cache, std::ostream& out)
+{
+    if constexpr (is_sliced_cache<CACHE>::value)
+        cache->print_stats(out);
+}
+/*
+ * Sends a message of `bytes` between core `coreid` and the slice that holds `address`
+ * (if `CACHE` has an interconnect). Used for coherence messages, which do not go through
+ * the slices' queues.
+ * */
+template <class CACHE> inline void
+noc_send_coherence(const std::unique_ptr<CACHE>& cache, uint64_t address, uint8_t coreid, size_t bytes, bool to_core)
+{
+    if constexpr (is_sliced_cache<CACHE>::value) {
+        if constexpr (CACHE::HAS_NOC) {
+            const auto& noc = cache->noc_;
+            size_t slice = noc->slice_stop(CACHE::slice_index(address)),
+                   core = noc->core_stop(coreid);
+            if (to_core)
+                noc->send(slice, core, bytes);
+            else
+                noc->send(core, slice, bytes);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#include "cache/sliced.tpp"
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // CACHE_SLICED_h
@@ -0,0 +1,198 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#include <iostream>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+template <class NEXT> bool
+InterconnectPort<NEXT>::IO::add_incoming(Transaction t)
+{
+    InterconnectPort* p = parent_;
+    if (!p->next_->io_->add_incoming(t))
+        return false;
+    bool is_write = t.type == TransactionType::WRITE;
+    uint64_t latency = p->noc_.send(p->noc_.slice_stop(p->slice_index_(t.address)),
+                                    p->noc_.mc_stop(),
+                                    is_write ? Interconnect::DATA_BYTES : Interconnect::CONTROL_BYTES);
+    if (!is_write)
+        p->read_latency_[t.address] = latency;
+    return true;
+}
+
+template <class NEXT> uint64_t
+InterconnectPort<NEXT>::take_read_latency(uint64_t address)
+{
+    auto it = read_latency_.find(address);
+    if (it == read_latency_.end())
+        return 0;
+    uint64_t latency = it->second;
+    read_latency_.erase(it);
+    return latency;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#define __TEMPLATE_HEADER__ template <class SLICE, class NEXT, size_t N, size_t SLICE_SETS, size_t HOP_LATENCY>
+#define __TEMPLATE_CLASS__  SlicedCacheControl<SLICE, NEXT, N, SLICE_SETS, HOP_LATENCY>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ bool
+__TEMPLATE_CLASS__::Router::add_incoming(Transaction t)
+{
+    SlicedCacheControl* p = parent_;
+    size_t i = slice_index(t.address);
+    if constexpr (HAS_NOC) {
+        size_t src = p->noc_->core_stop(t.coreid),
+               dst = p->noc_->slice_stop(i);
+        size_t bytes = t.type == TransactionType::WRITE ? Interconnect::DATA_BYTES : Interconnect::CONTROL_BYTES;
+        // The request is only sent if the slice accepts it.
+        t.noc_latency = p->noc_->latency(src, dst, bytes);
+        if (!p->slices_[i]->io_->add_incoming(t))
+            return false;
+        p->noc_->send(src, dst, bytes);
+    } else {
+        if (!p->slices_[i]->io_->add_incoming(t))
+            return false;
+    }
+    ++p->s_slice_accesses_[i];
+    return true;
+}
+
+__TEMPLATE_HEADER__ size_t
+__TEMPLATE_CLASS__::Router::prefetch_queue_free() const
+{
+    size_t free = std::numeric_limits<size_t>::max();
+    for (const auto& s : parent_->slices_)
+        free = std::min(free, s->io_->prefetch_queue_free());
+    return free;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__
+__TEMPLATE_CLASS__::SlicedCacheControl(std::string cache_name, next_ptr& n)
+    :io_(new Router(this)),
+    cache_name_(cache_name)
+{
+    if constexpr (HAS_NOC) {
+        noc_ = noc_ptr(new Interconnect(N));
+        port_ = port_ptr(new InterconnectPort<NEXT>(n, *noc_, &slice_index));
+    }
+    for (size_t i = 0; i < N; i++) {
+        std::string name = cache_name + "_S" + std::to_string(i);
+        if constexpr (HAS_NOC)
+            slices_[i] = slice_ptr(new SLICE(name, port_));
+        else
+            slices_[i] = slice_ptr(new SLICE(name, n));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::tick()
+{
+    while (!pending_fills_.empty() && pending_fills_.top().first <= GL_CYCLE) {
+        uint64_t address = pending_fills_.top().second;
+        pending_fills_.pop();
+        size_t i = slice_index(address);
+        slices_[i]->mark_load_as_done(address);
+    }
+    for (size_t i = 0; i < N; i++) {
+        slices_[i]->tick();
+        collect_outgoing(i);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::mark_load_as_done(uint64_t address)
+{
+    size_t i = slice_index(address);
+    if constexpr (HAS_NOC) {
+        // The fill is delayed by the read and the fill's trip through the interconnect.
+        uint64_t latency = port_->take_read_latency(address) 
+                            + noc_->send(noc_->mc_stop(), noc_->slice_stop(i), Interconnect::DATA_BYTES);
+        pending_fills_.emplace(GL_CYCLE+latency, address);
+    } else {
+        slices_[i]->mark_load_as_done(address);
+        collect_outgoing(i);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ bool
+__TEMPLATE_CLASS__::deadlock_find_inst(const iptr_t& inst)
+{
+    return std::any_of(slices_.begin(), slices_.end(),
+                    [&inst] (slice_ptr& s)
+                    {
+                        return s->deadlock_find_inst(inst);
+                    });
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ CacheCoreStats
+__TEMPLATE_CLASS__::stats_for_core(uint8_t coreid) const
+{
+    CacheCoreStats st;
+    for (const slice_ptr& s : slices_)
+        st += s->stats_for_core(coreid);
+    return st;
+}
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::print_stats(std::ostream& out)
+{
+    out << BAR << "\n";
+    print_vecstat(out, cache_name_, "SLICE_ACCESSES", s_slice_accesses_);
+    if constexpr (HAS_NOC)
+        noc_->print_stats(out);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::collect_outgoing(size_t slice_idx)
+{
+    auto& q = slices_[slice_idx]->io_->outgoing_queue_;
+    while (!q.empty()) {
+        auto [t, cycle_done] = q.top();
+        if constexpr (HAS_NOC) {
+            // Responses enter the interconnect once they leave the slice.
+            if (cycle_done > GL_CYCLE)
+                return;
+            uint64_t latency = t.noc_latency 
+                                + noc_->send(noc_->slice_stop(slice_idx), noc_->core_stop(t.coreid), Interconnect::DATA_BYTES);
+            io_->outgoing_queue_.emplace(t, GL_CYCLE+latency);
+        } else {
+            io_->outgoing_queue_.emplace(t, cycle_done + hop_latency(t.coreid, slice_idx));
+        }
+        q.pop();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#undef __TEMPLATE_HEADER__
+#undef __TEMPLATE_CLASS__
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
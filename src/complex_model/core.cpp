@@ -6,8 +6,11 @@
 #include "globals.h"
 #include "memsys.h"
 
+#include "cache/directory.h"
+#include "cache/sliced.h"
 #include "complex_model/core.h"
 #include "complex_model/os.h"
+#include "interconnect.h"
 #include "trace/reader.h"
 #include "os/address.h"
 #include "util/stats.h"
@@ -60,15 +63,19 @@ Core::tick_warmup()
     iptr_t inst = next_inst(true);
     // First do icache access
     inst->pip = GL_OS->warmup_translate_ip(coreid_, inst->ip);
-    L1I_->warmup_access(LINEADDR(inst->pip), false);
+    L1I_->warmup_access(LINEADDR(inst->pip), false, inst->ip, coreid_);
     // Now do data access
     for (Memop& x : inst->loads) {
         x.p_lineaddr = GL_OS->warmup_translate_ldst(this->coreid_, x.v_lineaddr);
-        L1D_->warmup_access(x.p_lineaddr, false);
+        if constexpr (OS_SHARED_ADDRESS_SPACE)
+            coherence_read(x.p_lineaddr, true);
+        L1D_->warmup_access(x.p_lineaddr, false, inst->ip, coreid_);
     }
     for (Memop& x : inst->stores) {
         x.p_lineaddr = GL_OS->warmup_translate_ldst(this->coreid_, x.v_lineaddr);
-        L1D_->warmup_access(x.p_lineaddr, true);
+        if constexpr (OS_SHARED_ADDRESS_SPACE)
+            coherence_write(x.p_lineaddr, true);
+        L1D_->warmup_access(x.p_lineaddr, true, inst->ip, coreid_);
     }
 }
 
@@ -86,6 +93,8 @@ Core::tick()
         iftr(i);
         ifbp(i);
     }
+    if constexpr (CORE_FDIP_DEPTH > 0)
+        fdip();
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -106,6 +115,16 @@ Core::checkpoint_stats()
 
     print_stat(stats_stream_, header, "IFMEM_STALLS", s_ifmem_stalls_);
     print_stat(stats_stream_, header, "DISP_STALLS", s_disp_stalls_);
+    if constexpr (CORE_FDIP_DEPTH > 0)
+        print_stat(stats_stream_, header, "FDIP_PREFETCHES", s_fdip_prefetches_);
+    if constexpr (OS_SHARED_ADDRESS_SPACE) {
+        print_stat(stats_stream_, header, "COHERENCE_MISSES", s_coherence_misses_);
+        print_stat(stats_stream_, header, "COHERENCE_UPGRADES", s_coherence_upgrades_);
+        print_stat(stats_stream_, header, "COHERENCE_INVALIDATIONS", s_coherence_invalidations_);
+        print_stat(stats_stream_, header, "COHERENCE_DOWNGRADES", s_coherence_downgrades_);
+        print_stat(stats_stream_, header, "COHERENCE_WRITEBACKS", s_coherence_writebacks_);
+        print_stat(stats_stream_, header, "COHERENCE_BACK_INVALIDATIONS", s_coherence_back_invalidations_);
+    }
 
     stats_stream_ << BAR << "\n";
 
@@ -129,6 +148,121 @@ Core::print_stats(std::ostream& out)
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
+void
+Core::coherence_read(uint64_t lineaddr, bool warmup)
+{
+    Directory::Action a = GL_DIRECTORY->read(coreid_, lineaddr);
+    if (a.evicted_sharers)
+        coherence_back_invalidate(a.evicted_line, a.evicted_sharers, warmup);
+    if (!warmup && a.coherence_miss)
+        ++s_coherence_misses_;
+    // The owner keeps its copy, but a dirty line is written back to the LLC.
+    for (size_t i = 0; i < NUM_THREADS; i++) {
+        if (!(a.downgrade & (1ull << i)))
+            continue;
+        auto& c = GL_CORES[i];
+        // The owner may have evicted the line silently.
+        if (!c->holds_line(lineaddr)) {
+            GL_DIRECTORY->remove_sharer(i, lineaddr);
+            continue;
+        }
+        bool dirty = c->L1D_->cache_->clear_dirty(lineaddr);
+        dirty |= c->L2_->cache_->clear_dirty(lineaddr);
+        if (warmup) {
+            if (dirty)
+                GL_LLC->warmup_access(lineaddr, true, 0, i);
+            continue;
+        }
+        ++c->s_coherence_downgrades_;
+        // The request from the directory and the acknowledgement (the writeback carries the data).
+        noc_send_coherence(GL_LLC, lineaddr, i, Interconnect::CONTROL_BYTES, true);
+        noc_send_coherence(GL_LLC, lineaddr, i, Interconnect::CONTROL_BYTES, false);
+        if (!dirty)
+            continue;
+        // If the LLC cannot take the writeback, the line stays dirty in the owner (and is
+        // written back when it is evicted).
+        Transaction t(i, nullptr, TransactionType::WRITE, lineaddr);
+        if (GL_LLC->io_->add_incoming(t))
+            ++c->s_coherence_writebacks_;
+        else if (!c->L2_->cache_->mark_dirty(lineaddr))
+            c->L1D_->cache_->mark_dirty(lineaddr);
+    }
+}
+
+void
+Core::coherence_write(uint64_t lineaddr, bool warmup)
+{
+    Directory::Action a = GL_DIRECTORY->write(coreid_, lineaddr);
+    if (a.evicted_sharers)
+        coherence_back_invalidate(a.evicted_line, a.evicted_sharers, warmup);
+    if (!warmup) {
+        if (a.coherence_miss)
+            ++s_coherence_misses_;
+        // A write miss asks for ownership with its read, but a hit needs its own request
+        // (the writer may have evicted the line silently, so the write may still miss).
+        if (a.upgrade && holds_line(lineaddr)) {
+            ++s_coherence_upgrades_;
+            noc_send_coherence(GL_LLC, lineaddr, coreid_, Interconnect::CONTROL_BYTES, false);
+            noc_send_coherence(GL_LLC, lineaddr, coreid_, Interconnect::CONTROL_BYTES, true);
+        }
+    }
+    // A dirty line is passed to the writer (which overwrites it), so it is not written back.
+    for (size_t i = 0; i < NUM_THREADS; i++) {
+        if (!(a.invalidate & (1ull << i)))
+            continue;
+        auto& c = GL_CORES[i];
+        // A sharer that evicted the line silently has nothing to invalidate (the directory
+        // has already dropped it).
+        if (!c->holds_line(lineaddr))
+            continue;
+        bool dirty = c->L1D_->cache_->remove(lineaddr);
+        dirty |= c->L2_->cache_->remove(lineaddr);
+        GL_DIRECTORY->mark_invalidated(i, lineaddr);
+        if (warmup)
+            continue;
+        ++c->s_coherence_invalidations_;
+        noc_send_coherence(GL_LLC, lineaddr, i, Interconnect::CONTROL_BYTES, true);
+        noc_send_coherence(GL_LLC, lineaddr, i, dirty ? Interconnect::DATA_BYTES : Interconnect::CONTROL_BYTES, false);
+    }
+}
+
+void
+Core::coherence_back_invalidate(uint64_t lineaddr, uint64_t sharers, bool warmup)
+{
+    for (size_t i = 0; i < NUM_THREADS; i++) {
+        if (!(sharers & (1ull << i)))
+            continue;
+        auto& c = GL_CORES[i];
+        if (!c->holds_line(lineaddr))
+            continue;
+        bool dirty = c->L1D_->cache_->remove(lineaddr);
+        dirty |= c->L2_->cache_->remove(lineaddr);
+        if (!warmup) {
+            ++c->s_coherence_back_invalidations_;
+            noc_send_coherence(GL_LLC, lineaddr, i, Interconnect::CONTROL_BYTES, true);
+            noc_send_coherence(GL_LLC, lineaddr, i, dirty ? Interconnect::DATA_BYTES : Interconnect::CONTROL_BYTES, false);
+        }
+        if (!dirty)
+            continue;
+        // The line is gone from the core, so if the LLC cannot take the writeback, the data
+        // is written to the LLC directly (without timing).
+        Transaction t(i, nullptr, TransactionType::WRITE, lineaddr);
+        if (warmup || !GL_LLC->io_->add_incoming(t))
+            GL_LLC->warmup_access(lineaddr, true, 0, i);
+        else
+            ++c->s_coherence_writebacks_;
+    }
+}
+
+bool
+Core::holds_line(uint64_t lineaddr)
+{
+    return L1D_->cache_->contains(lineaddr) || L2_->cache_->contains(lineaddr);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
 void
 Core::ifbp(size_t fwid)
 {
@@ -155,12 +289,20 @@ Core::iftr(size_t fwid)
         return;
 
     iptr_t& inst = la.inst;
-    if (la_next.stalled || !GL_OS->translate_ip(coreid_, inst)) {
+    if (la_next.stalled) {
         ++s_iftr_stalls_;
         la.stalled = true;
         return;
     }
-    inst->ip_state = AccessState::IN_TLB;
+    // FDIP may have already sent the translation.
+    if (inst->ip_state == AccessState::NOT_READY) {
+        if (!GL_OS->translate_ip(coreid_, inst)) {
+            ++s_iftr_stalls_;
+            la.stalled = true;
+            return;
+        }
+        inst->ip_state = AccessState::IN_TLB;
+    }
 
     la.valid = false;
     la_next.inst = std::move(la.inst);
@@ -244,6 +386,42 @@ Core::disp(size_t fwid)
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
+void
+Core::fdip()
+{
+    // Prefetch the lines of any translated instructions. Drop any that IFbp has
+    // already taken, as the demand access will fetch the line.
+    while (!fdip_pending_.empty()) {
+        iptr_t& inst = fdip_pending_.front();
+        if (fdip_queue_.empty() || inst->inst_num < fdip_queue_.front()->inst_num) {
+            fdip_pending_.pop_front();
+            continue;
+        }
+        if (inst->ip_state != AccessState::READY)
+            break;
+        Transaction t(coreid_, nullptr, TransactionType::PREFETCH, LINEADDR(inst->pip), true);
+        t.pf_source = CachePrefetcher::FDIP;
+        if (!L1I_->io_->add_incoming(t))
+            break;
+        ++s_fdip_prefetches_;
+        fdip_pending_.pop_front();
+    }
+    // Run ahead of IFbp.
+    for (size_t i = 0; i < CORE_FETCH_WIDTH && fdip_queue_.size() < CORE_FDIP_DEPTH; i++) {
+        iptr_t inst = iptr_t(new Instruction(inst_num_++, trace_reader_()));
+        uint64_t line = LINEADDR(inst->ip);
+        if (line != fdip_last_line_ && GL_OS->translate_ip(coreid_, inst)) {
+            inst->ip_state = AccessState::IN_TLB;
+            fdip_last_line_ = line;
+            fdip_pending_.push_back(inst);
+        }
+        fdip_queue_.push_back(std::move(inst));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
 void
 Core::operate_rob()
 {
@@ -372,6 +550,11 @@ Core::operate_caches()
 iptr_t
 Core::next_inst(bool warmup)
 {
+    if (!fdip_queue_.empty()) {
+        iptr_t inst = std::move(fdip_queue_.front());
+        fdip_queue_.pop_front();
+        return inst;
+    }
     iptr_t inst = iptr_t(new Instruction(inst_num_, trace_reader_())); 
     if (!warmup)
         ++inst_num_;
@@ -432,8 +615,11 @@ do_ldst(iptr_t& inst,
                 for (Memop& x : v) {
                     if (x.state == AccessState::READY) {
                         Transaction trans(coreid, inst, TTYPE, x.p_lineaddr);
-                        if (c->io_->add_incoming(trans))
+                        if (c->io_->add_incoming(trans)) {
                             x.state = AccessState::IN_CACHE;
+                            if constexpr (OS_SHARED_ADDRESS_SPACE && TTYPE == TransactionType::WRITE)
+                                GL_CORES[coreid]->coherence_write(x.p_lineaddr);
+                        }
                     }
                 }
             });
@@ -456,6 +642,11 @@ drain_llc_outgoing_queue()
             [] (const Transaction& t)
             {
                 auto& core = GL_CORES[t.coreid];
+                // Instructions are never written, so the directory does not track them.
+                if constexpr (OS_SHARED_ADDRESS_SPACE) {
+                    if (!t.address_is_ip)
+                        core->coherence_read(t.address);
+                }
                 core->L2_->mark_load_as_done(t.address);
             });
 }
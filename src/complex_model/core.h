@@ -14,6 +14,7 @@
 #include <deque>
 #include <memory>
 #include <iosfwd>
+#include <limits>
 #include <string>
 #include <sstream>
 
@@ -48,6 +49,27 @@ public:
     uint64_t s_iftr_stalls_ =0;
     uint64_t s_ifmem_stalls_ =0;
     uint64_t s_disp_stalls_ =0;
+    /*
+     * Number of L1i$ prefetches sent by FDIP.
+     * */
+    uint64_t s_fdip_prefetches_ =0;
+    /*
+     * Coherence stats (only if `OS_SHARED_ADDRESS_SPACE`, see `Directory`):
+     *  `s_coherence_misses_`: accesses to lines invalidated by another core's write.
+     *  `s_coherence_upgrades_`: writes to lines in `S` held by this core.
+     *  `s_coherence_invalidations_`: lines invalidated by another core's write.
+     *  `s_coherence_downgrades_`: lines downgraded to `S` by another core's read.
+     *  `s_coherence_writebacks_`: dirty lines written back to the LLC on a downgrade (or a
+     *      back-invalidation).
+     *  `s_coherence_back_invalidations_`: lines invalidated as the directory evicted them.
+     * Invalidations and downgrades are only counted if this core still held the line.
+     * */
+    uint64_t s_coherence_misses_ =0;
+    uint64_t s_coherence_upgrades_ =0;
+    uint64_t s_coherence_invalidations_ =0;
+    uint64_t s_coherence_downgrades_ =0;
+    uint64_t s_coherence_writebacks_ =0;
+    uint64_t s_coherence_back_invalidations_ =0;
 
     const uint8_t coreid_;
 private:
@@ -83,6 +105,16 @@ private:
     latch_t la_iftr_ifmem_;
     ftb_t ftb_;
     rob_t rob_;
+    /*
+     * Fetch-directed instruction prefetching (FDIP): `fdip()` reads up to `CORE_FDIP_DEPTH`
+     * instructions ahead of IFbp into `fdip_queue_`. The first instruction of each new
+     * fetch line is translated early (so IFtr can skip it), and once translated, its line
+     * is prefetched into the L1i$. Instructions waiting on a translation are held in
+     * `fdip_pending_`.
+     * */
+    ftb_t    fdip_queue_;
+    ftb_t    fdip_pending_;
+    uint64_t fdip_last_line_ =std::numeric_limits<uint64_t>::max();
     /*
      * Trace management:
      * */
@@ -106,11 +138,28 @@ public:
 
     void checkpoint_stats(void);
     void print_stats(std::ostream&);
+    /*
+     * Updates the directory for a read (a fill from the LLC) or a write by this core, and
+     * invalidates or downgrades the copies in the other cores' L1d$ and L2$. Only used if
+     * `OS_SHARED_ADDRESS_SPACE`.
+     * */
+    void coherence_read(uint64_t lineaddr, bool warmup=false);
+    void coherence_write(uint64_t lineaddr, bool warmup=false);
 private:
+    /*
+     * Invalidates a line evicted from the directory in the cores in `sharers`.
+     * */
+    void coherence_back_invalidate(uint64_t lineaddr, uint64_t sharers, bool warmup);
+    /*
+     * Returns true if the line is in this core's L1d$ or L2$.
+     * */
+    bool holds_line(uint64_t lineaddr);
+
     void ifbp(size_t fwid);
     void iftr(size_t fwid);
     void ifmem(size_t fwid);
     void disp(size_t fwid);
+    void fdip(void);
     void operate_rob(void);
     void operate_caches(void);
 
@@ -23,12 +23,13 @@ OS::OS(ptwc_init_list_t ptwc_init)
 {
     for (size_t i = 0; i < NUM_THREADS; i++) {
         // Initialize virtual memory and PTWs
-        vmem_[i] = vmem_ptr(new VirtualMemory(free_list_.get_and_reserve_free_page_frame()));
+        if (!OS_SHARED_ADDRESS_SPACE || i == 0)
+            vmem_[i] = vmem_ptr(new VirtualMemory(static_cast<uint8_t>(i), free_list_.get_and_reserve_free_page_frame()));
         ptw_[i] = ptw_ptr(new PageTableWalker(
                                 static_cast<uint8_t>(i),
                                 L2TLB_[i],
                                 GL_CORES[i]->L1D_,
-                                vmem_[i],
+                                get_vmem(i),
                                 ptwc_init));
         // Now do TLBs.
         L2TLB_[i] = l2tlb_ptr(new L2TLB("L2TLB", ptw_[i]));
@@ -52,13 +53,13 @@ warmup_translate(std::unique_ptr<CACHE_TYPE>& tlb, uint64_t addr, std::unique_pt
 uint64_t
 OS::warmup_translate_ip(uint8_t coreid, uint64_t ip)
 {
-    return warmup_translate<1>(ITLB_[coreid], ip, vmem_[coreid]);
+    return warmup_translate<1>(ITLB_[coreid], ip, get_vmem(coreid));
 }
 
 uint64_t
 OS::warmup_translate_ldst(uint8_t coreid, uint64_t addr)
 {
-    return warmup_translate<LINESIZE>(DTLB_[coreid], addr, vmem_[coreid]);
+    return warmup_translate<LINESIZE>(DTLB_[coreid], addr, get_vmem(coreid));
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -67,6 +68,10 @@ OS::warmup_translate_ldst(uint8_t coreid, uint64_t addr)
 void
 OS::tick()
 {
+    if (migrator_.epoch_done()) {
+        for (const auto& m : migrator_.migrate())
+            get_vmem(m.coreid)->remap(m.vpn, m.pfn);
+    }
     // Tick all PTWs
     for (size_t i = 0; i < NUM_THREADS; i++) {
         ptw_[i]->tick();
@@ -85,14 +90,14 @@ OS::tick()
                     // Just need to update instruction.
                     for (auto inst : t.inst_list) {
                         inst->ip_state = AccessState::READY;
-                        inst->pip = translate<1>(inst->ip, this->vmem_[i]);
+                        inst->pip = translate<1>(inst->ip, this->get_vmem(i));
                     }
                 });
         drain_cache_outgoing_queue(DTLB_[i],
                 [this, i] (const Transaction& t)
                 {
                     uint64_t vpn = t.address;
-                    uint64_t pfn = this->vmem_[i]->get_pfn(vpn);
+                    uint64_t pfn = this->get_vmem(i)->get_pfn(vpn);
                     for (auto inst : t.inst_list)
                         inst_dtlb_done(inst, vpn, pfn);
                 });
@@ -131,6 +136,10 @@ OS::print_stats(std::ostream& out)
 {
     out << BAR << "\n";
     print_stat(out, "OS", "PAGE_FAULTS", free_list_.s_page_faults_);
+    if constexpr (FAR_MEM_SIZE_MB > 0) {
+        print_stat(out, "OS", "FAR_MEM_PAGE_FAULTS", free_list_.s_far_page_faults_);
+        migrator_.print_stats(out);
+    }
     out << BAR << "\n";
     // Print out stats of page table walker caches.
     out << std::setw(12) << std::left << "PTW$";
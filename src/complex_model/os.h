@@ -10,6 +10,7 @@
 #include "complex_model/os/ptw.h"
 #include "complex_model/os/vmem.h"
 #include "os/free_list.h"
+#include "os/migration.h"
 
 #include <array>
 #include <iosfwd>
@@ -40,14 +41,16 @@ public:
     dtlb_array_t  DTLB_;
     l2tlb_array_t L2TLB_;
 
-    FreeList free_list_{};
+    FreeList     free_list_{};
+    PageMigrator migrator_{free_list_};
 private:
     using vmem_ptr = std::unique_ptr<VirtualMemory>;
     using ptw_ptr = std::unique_ptr<PageTableWalker>;
     using vmem_array_t = std::array<vmem_ptr, NUM_THREADS>;
     using ptw_array_t = std::array<ptw_ptr, NUM_THREADS>;
     /*
-     * Each core has its own virtual memory and page walker (`CoreMMU`):
+     * Each core has its own virtual memory and page walker (`CoreMMU`). If
+     * `OS_SHARED_ADDRESS_SPACE`, only `vmem_[0]` exists, and all cores use it (see `get_vmem`).
      * */
     vmem_array_t vmem_;
     ptw_array_t  ptw_;
@@ -72,6 +75,11 @@ public:
     {
         ptw_[coreid]->handle_l1d_outgoing(t);
     }
+private:
+    inline vmem_ptr& get_vmem(uint8_t coreid)
+    {
+        return OS_SHARED_ADDRESS_SPACE ? vmem_[0] : vmem_[coreid];
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////
@@ -58,7 +58,7 @@ PageTableWalker::PageTableWalker(
 ////////////////////////////////////////////////////////////////////////////
 
 void
-PageTableWalker::warmup_access(uint64_t vpn, bool)
+PageTableWalker::warmup_access(uint64_t vpn, bool, uint64_t, uint8_t)
 {
     // Do page table walk + access all caches.
     vmem_->do_page_walk(vpn);
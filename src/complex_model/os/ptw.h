@@ -102,9 +102,9 @@ public:
     PageTableWalker(uint8_t coreid, l2tlb_ptr&, l1d_ptr&, vmem_ptr&, ptwc_init_list_t);
     /*
      * This `warmup_access` method mimics the same method found in `CacheControl (control.tpp)`.
-     * Note that the second argument, `write`, is unused.
+     * Note that the remaining arguments (`write`, `ip`, and `coreid`) are unused.
      * */
-    void warmup_access(uint64_t vpn, bool);
+    void warmup_access(uint64_t vpn, bool, uint64_t ip=0, uint8_t coreid=0);
 
     void tick(void);
     void handle_tlb_miss(const Transaction&);
@@ -13,8 +13,9 @@
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
-VirtualMemory::VirtualMemory(uint64_t ptbr)
-    :ptbr_(ptbr),
+VirtualMemory::VirtualMemory(uint8_t coreid, uint64_t ptbr)
+    :coreid_(coreid),
+    ptbr_(ptbr),
     base_pt_(new page_table_t)
 {
     base_pt_->fill(nullptr);
@@ -76,10 +77,24 @@ VirtualMemory::do_page_walk(uint64_t vpn)
     // At the lowest level, which will have the pfn.
     pte_ptr e = access_entry_and_alloc_if_dne(curr_pt, levels[0]);
     out[0] = e->pfn;
+    if (!vpn_to_pfn_memo_.count(vpn))
+        GL_OS->migrator_.register_page(e->pfn, coreid_, vpn);
     vpn_to_pfn_memo_[vpn] = e->pfn;
     return out;
 }
 
+void
+VirtualMemory::remap(uint64_t vpn, uint64_t pfn)
+{
+    page_table_ptr curr_pt = base_pt_;
+    for (size_t i = PT_LEVELS-1; i > 0; i--) {
+        size_t idx = fast_mod<NUM_PTE_PER_TABLE>(vpn >> (i*numeric_traits<NUM_PTE_PER_TABLE>::log2));
+        curr_pt = curr_pt->at(idx)->next;
+    }
+    curr_pt->at(fast_mod<NUM_PTE_PER_TABLE>(vpn))->pfn = pfn;
+    vpn_to_pfn_memo_[vpn] = pfn;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
@@ -42,6 +42,7 @@ class VirtualMemory
 public:
     uint64_t s_page_faults_ =0;
     
+    const uint8_t  coreid_;
     const uint64_t ptbr_;
 private:
     using memo_t = std::unordered_map<uint64_t, uint64_t>;
@@ -67,7 +68,7 @@ public:
      * */
     using walk_result_t = std::array<uint64_t, 2*PT_LEVELS+1>;
 
-    VirtualMemory(uint64_t ptbr);
+    VirtualMemory(uint8_t coreid, uint64_t ptbr);
     ~VirtualMemory(void);
     /*
      * Performs a walk starting from `base_pt_` to find the page frame of `vpn`.
@@ -87,6 +88,10 @@ public:
             do_page_walk(vpn);
         return vpn_to_pfn_memo_.at(vpn);
     }
+    /*
+     * Points the (existing) translation for `vpn` to `pfn`. Used for page migration.
+     * */
+    void remap(uint64_t vpn, uint64_t pfn);
 private:
     pte_ptr access_entry_and_alloc_if_dne(page_table_ptr, size_t idx);
     pte_ptr make_new_pte(void);
@@ -8,11 +8,19 @@
 #include "memsys.h"
 
 #include "dram.h"
+#include "dram_timing.h"
 #include "dram/address.h"
+#include "dram/cache.h"
 #include "dram/channel.h"
+#include "dram/far_memory.h"
 #include "io_bus.h"
+#include "os/free_list.h"
+#include "util/numerics.h"
 #include "util/stats.h"
 
+#include <algorithm>
+#include <string>
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
@@ -28,8 +36,16 @@ DRAM::IO::IO(DRAM* d)
 bool
 DRAM::IO::add_incoming(Transaction t)
 {
-    size_t ch = dram_channel(t.address);
-    return dram->channels_[ch]->io_->add_incoming(t);
+    bool accepted;
+    if constexpr (DRAM_CACHE_SIZE_MB > 0)
+        accepted = dram->dram_cache_->add_incoming(t);
+    else
+        accepted = dram->route(t);
+    if (!accepted)
+        return false;
+    if constexpr (MEM_PLACEMENT == MemPlacement::HOTNESS && FAR_MEM_SIZE_MB > 0)
+        ++dram->page_accesses_[t.address >> numeric_traits<PAGESIZE/LINESIZE>::log2];
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -41,7 +57,11 @@ DRAM::DRAM(double cpu_freq_ghz, double freq_ghz)
     clock_scale_(cpu_freq_ghz/freq_ghz - 1.0)
 {
     for (size_t i = 0; i < DRAM_CHANNELS; i++)
-        channels_[i] = channel_ptr(new DRAMChannel(freq_ghz));
+        channels_[i] = channel_ptr(new DRAMChannel<DRAMTiming>(freq_ghz, cpu_freq_ghz));
+    if constexpr (FAR_MEM_SIZE_MB > 0)
+        far_mem_ = far_mem_ptr(new FarMemory(cpu_freq_ghz));
+    if constexpr (DRAM_CACHE_SIZE_MB > 0)
+        dram_cache_ = dram_cache_ptr(new DRAMCache(this, freq_ghz, cpu_freq_ghz));
 }
 
 DRAM::~DRAM() {}
@@ -49,21 +69,46 @@ DRAM::~DRAM() {}
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
+template <class IO_PTR, class F> inline void
+drain_completed_reads(IO_PTR& io, F on_done)
+{
+    auto& q = io->outgoing_queue_;
+    while (!q.empty()) {
+        const auto& [t, cycle_done] = q.top();
+        if (GL_CYCLE < cycle_done)
+            break;
+        on_done(t);
+        q.pop();
+    }
+}
+
 void
 DRAM::tick()
 {
     for (channel_ptr& ch : channels_) {
-        auto& q = ch->io_->outgoing_queue_;
-        while (!q.empty()) {
-            const auto& [t, cycle_done] = q.top();
-            if (GL_CYCLE < cycle_done)
-                break;
-            GL_LLC->mark_load_as_done(t.address);
-            q.pop();
-        }
-        if (leap_ < 1.0)
+        drain_completed_reads(ch->io_, [this] (const Transaction& t) { this->read_done(t); });
+        if (leap_ < 1.0 && GL_DRAM_CYCLE >= ch->next_event_cycle_)
             ch->tick();
     }
+    // Far memory runs at the CPU clock.
+    if constexpr (FAR_MEM_SIZE_MB > 0) {
+        drain_completed_reads(far_mem_->io_, [this] (const Transaction& t) { this->read_done(t); });
+        far_mem_->tick();
+    }
+    if constexpr (DRAM_CACHE_SIZE_MB > 0) {
+        for (auto& ch : dram_cache_->channels_) {
+            drain_completed_reads(ch->io_,
+                    [this] (const Transaction& t)
+                    {
+                        this->dram_cache_->cache_read_done(t.address);
+                    });
+            if (leap_ < 1.0 && GL_DRAM_CYCLE >= ch->next_event_cycle_)
+                ch->tick();
+        }
+        dram_cache_->tick();
+    }
+    if (!migration_queue_.empty() && route(migration_queue_.front()))
+        migration_queue_.pop_front();
 
     if (leap_ >= 1.0) {
         leap_ -= 1.0;
@@ -73,6 +118,51 @@ DRAM::tick()
     }
 }
 
+void
+DRAM::migrate_page(uint64_t src_pfn, uint64_t dst_pfn, uint8_t coreid)
+{
+    constexpr size_t LINES_PER_PAGE = PAGESIZE/LINESIZE;
+    for (size_t i = 0; i < LINES_PER_PAGE; i++) {
+        uint64_t src = src_pfn*LINES_PER_PAGE + i,
+                 dst = dst_pfn*LINES_PER_PAGE + i;
+        Transaction rd(coreid, nullptr, TransactionType::MIGRATION, src),
+                    wr(coreid, nullptr, TransactionType::WRITE, dst);
+        migration_queue_.push_back(rd);
+        migration_queue_.push_back(wr);
+    }
+    s_migration_lines_ += LINES_PER_PAGE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+DRAM::read_done(const Transaction& t)
+{
+    if constexpr (DRAM_CACHE_SIZE_MB > 0)
+        dram_cache_->mem_read_done(t.address);
+    else
+        GL_LLC->mark_load_as_done(t.address);
+}
+
+bool
+DRAM::route(Transaction t)
+{
+    t.dram_cycle_arrived = GL_DRAM_CYCLE;
+    if constexpr (FAR_MEM_SIZE_MB > 0) {
+        uint64_t pfn = t.address >> numeric_traits<PAGESIZE/LINESIZE>::log2;
+        if (page_frame_tier(pfn) == MemTier::FAR_MEM)
+            return far_mem_->io_->add_incoming(t);
+    }
+    auto& ch = channels_[dram_channel(t.address)];
+    if (ch->io_->add_incoming(t)) {
+        ch->wake();
+        return true;
+    } else {
+        return false;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
@@ -91,6 +181,9 @@ DRAM::print_stats(std::ostream& out)
     CREATE_VEC_STAT(activates)
     CREATE_VEC_STAT(refreshes)
     CREATE_VEC_STAT(pre_demand)
+    CREATE_VEC_STAT(pre_premature)
+    CREATE_VEC_STAT(pre_late)
+    CREATE_VEC_STAT(rank_switches)
     CREATE_VEC_STAT(row_buffer_hits)
 
     VecStat<double, DRAM_CHANNELS> rbhr;
@@ -102,6 +195,48 @@ DRAM::print_stats(std::ostream& out)
     }
     VecStat<double, DRAM_CHANNELS> write_blocked_prop = mean(write_blocked_cycles, GL_DRAM_CYCLE);
 
+    VecStat<uint64_t, DRAM_CHANNELS> rd_to_wr,
+                                     wr_to_rd,
+                                     drain_cycles;
+    for (size_t i = 0; i < DRAM_CHANNELS; i++) {
+        rd_to_wr[i] = channels_[i]->io_->s_rd_to_wr_turnarounds_;
+        wr_to_rd[i] = channels_[i]->io_->s_wr_to_rd_turnarounds_;
+        drain_cycles[i] = channels_[i]->io_->s_drain_cycles_;
+    }
+    VecStat<double, DRAM_CHANNELS> drain_prop = mean(drain_cycles, GL_DRAM_CYCLE);
+    // Energy stats (reported in nJ and mW).
+    VecStat<double, DRAM_CHANNELS> energy_act,
+                                   energy_rdwr,
+                                   energy_ref,
+                                   energy_bg,
+                                   energy_tot,
+                                   energy_per_access,
+                                   avg_power;
+    const double sim_time_ns = GL_DRAM_CYCLE / freq_ghz_;
+    for (size_t i = 0; i < DRAM_CHANNELS; i++) {
+        DRAMEnergy e = channels_[i]->compute_energy();
+        energy_act[i] = e.act * 1e-3;
+        energy_rdwr[i] = (e.rd + e.wr) * 1e-3;
+        energy_ref[i] = e.ref * 1e-3;
+        energy_bg[i] = (e.act_stby + e.pre_stby) * 1e-3;
+        energy_tot[i] = e.total() * 1e-3;
+        energy_per_access[i] = energy_tot[i] / static_cast<double>(vec_reads[i] + vec_writes[i]);
+        avg_power[i] = e.total() / sim_time_ns;
+    }
+
+    // Bandwidth stats (in GB/s). The peak assumes one `BL/2`-cycle burst per line
+    // on each sub-channel's data bus.
+    VecStat<double, DRAM_CHANNELS> bandwidth,
+                                   bus_util,
+                                   bus_idle_queued;
+    for (size_t i = 0; i < DRAM_CHANNELS; i++) {
+        channels_[i]->update_bus_stats();
+        bandwidth[i] = static_cast<double>((vec_reads[i] + vec_writes[i]) * LINESIZE) / sim_time_ns;
+        bus_util[i] = mean(channels_[i]->s_data_bus_busy_cycles_, GL_DRAM_CYCLE*DRAM_SUBCHANNELS);
+        bus_idle_queued[i] = mean(channels_[i]->s_data_bus_idle_queued_cycles_, GL_DRAM_CYCLE*DRAM_SUBCHANNELS);
+    }
+    const double peak_bandwidth = DRAM_SUBCHANNELS * LINESIZE * freq_ghz_ / (DRAM_BURST_LENGTH/2);
+
     out << BAR << "\n";
 
     print_vecstat(out, "DRAM", "NUM_READS", vec_reads);
@@ -110,11 +245,170 @@ DRAM::print_stats(std::ostream& out)
     print_vecstat(out, "DRAM", "NUM_ACTIVATE", vec_activates);
     print_vecstat(out, "DRAM", "NUM_REFRESH", vec_refreshes);
     print_vecstat(out, "DRAM", "NUM_PREDEMAND", vec_pre_demand);
+    print_vecstat(out, "DRAM", "NUM_PRE_PREMATURE", vec_pre_premature);
+    print_vecstat(out, "DRAM", "NUM_PRE_LATE", vec_pre_late);
+    print_vecstat(out, "DRAM", "NUM_RANK_SWITCHES", vec_rank_switches);
     print_vecstat(out, "DRAM", "ROW_BUFFER_HITS", vec_row_buffer_hits);
 
     print_vecstat(out, "DRAM", "ROW_BUFFER_HIT_RATE", rbhr, VecAccMode::HMEAN);
     print_vecstat(out, "DRAM", "WRITE_BLOCKED_CYCLES", write_blocked_cycles, VecAccMode::AMEAN);
     print_vecstat(out, "DRAM", "WRITE_BLOCKED_FRACTION", write_blocked_prop, VecAccMode::GMEAN);
+    print_vecstat(out, "DRAM", "RD_TO_WR_TURNAROUNDS", rd_to_wr);
+    print_vecstat(out, "DRAM", "WR_TO_RD_TURNAROUNDS", wr_to_rd);
+    print_vecstat(out, "DRAM", "WRITE_DRAIN_CYCLES", drain_cycles, VecAccMode::AMEAN);
+    print_vecstat(out, "DRAM", "WRITE_DRAIN_FRACTION", drain_prop, VecAccMode::AMEAN);
+
+    print_vecstat(out, "DRAM", "BANDWIDTH_GBPS", bandwidth);
+    print_stat(out, "DRAM", "PEAK_BANDWIDTH_GBPS_PER_CHANNEL", peak_bandwidth);
+    print_vecstat(out, "DRAM", "DATA_BUS_UTILIZATION", bus_util, VecAccMode::AMEAN);
+    print_vecstat(out, "DRAM", "DATA_BUS_IDLE_WHILE_QUEUED", bus_idle_queued, VecAccMode::AMEAN);
+
+    print_vecstat(out, "DRAM", "ENERGY_ACT_NJ", energy_act);
+    print_vecstat(out, "DRAM", "ENERGY_RDWR_NJ", energy_rdwr);
+    print_vecstat(out, "DRAM", "ENERGY_REF_NJ", energy_ref);
+    print_vecstat(out, "DRAM", "ENERGY_BACKGROUND_NJ", energy_bg);
+    print_vecstat(out, "DRAM", "ENERGY_TOTAL_NJ", energy_tot);
+    print_vecstat(out, "DRAM", "ENERGY_PER_ACCESS_NJ", energy_per_access, VecAccMode::AMEAN);
+    print_vecstat(out, "DRAM", "AVG_POWER_MW", avg_power);
+
+    // Per-core stats (summed over channels). The slowdown of a core is its average
+    // queueing latency relative to its latency without interference from other cores.
+    VecStat<uint64_t, NUM_THREADS> core_cas{},
+                                   core_queue_latency{},
+                                   core_interference{};
+    for (size_t i = 0; i < DRAM_CHANNELS; i++) {
+        for (size_t c = 0; c < NUM_THREADS; c++) {
+            core_cas[c] += channels_[i]->s_core_cas_[c];
+            core_queue_latency[c] += channels_[i]->s_core_queue_latency_[c];
+            core_interference[c] += channels_[i]->s_core_interference_[c];
+        }
+    }
+    VecStat<double, NUM_THREADS> core_avg_latency,
+                                 core_slowdown;
+    for (size_t c = 0; c < NUM_THREADS; c++) {
+        core_avg_latency[c] = mean(core_queue_latency[c], core_cas[c]);
+        uint64_t alone = core_queue_latency[c] - std::min(core_interference[c], core_queue_latency[c]);
+        core_slowdown[c] = (alone == 0) ? 1.0 : mean(core_queue_latency[c], alone);
+    }
+    auto [min_sd, max_sd] = std::minmax_element(core_slowdown.begin(), core_slowdown.end());
+    double unfairness = *max_sd / *min_sd;
+
+    print_vecstat(out, "DRAM", "CORE_CAS", core_cas);
+    print_vecstat(out, "DRAM", "CORE_QUEUE_LATENCY", core_avg_latency, VecAccMode::AMEAN);
+    print_vecstat(out, "DRAM", "CORE_SLOWDOWN", core_slowdown, VecAccMode::AMEAN);
+    print_stat(out, "DRAM", "UNFAIRNESS", unfairness);
+
+    // Read latency breakdown (in DRAM cycles). The last column is over all channels.
+    auto print_latency =
+        [this, &out] (std::string_view name, LogHistogram DRAMChannel<DRAMTiming>::* hist)
+        {
+            LogHistogram all;
+            VecStat<double, DRAM_CHANNELS+1> avg, p50, p99, max;
+            for (size_t i = 0; i <= DRAM_CHANNELS; i++) {
+                if (i < DRAM_CHANNELS)
+                    all += channels_[i].get()->*hist;
+                const LogHistogram& h = (i < DRAM_CHANNELS) ? channels_[i].get()->*hist : all;
+                avg[i] = h.amean();
+                p50[i] = h.percentile(0.5);
+                p99[i] = h.percentile(0.99);
+                max[i] = h.max;
+            }
+            std::string s(name);
+            print_vecstat(out, "DRAM", s + "_AVG", avg, VecAccMode::NONE);
+            print_vecstat(out, "DRAM", s + "_P50", p50, VecAccMode::NONE);
+            print_vecstat(out, "DRAM", s + "_P99", p99, VecAccMode::NONE);
+            print_vecstat(out, "DRAM", s + "_MAX", max, VecAccMode::NONE);
+        };
+    print_latency("READ_QUEUE_WAIT", &DRAMChannel<DRAMTiming>::s_rq_wait_hist_);
+    print_latency("CMD_QUEUE_WAIT", &DRAMChannel<DRAMTiming>::s_cmdq_wait_hist_);
+    print_latency("ROW_MISS_OVERHEAD", &DRAMChannel<DRAMTiming>::s_row_miss_hist_);
+    print_stat(out, "DRAM", "READ_BURST_CYCLES", DRAMTiming::CL + DRAMTiming::BL/2);
+    print_latency("READ_LATENCY", &DRAMChannel<DRAMTiming>::s_read_latency_hist_);
+    // Print the read latency histogram from the first to the last non-empty bucket.
+    LogHistogram all_latency;
+    for (const channel_ptr& ch : channels_)
+        all_latency += ch->s_read_latency_hist_;
+    size_t b_first = 0,
+           b_last = LogHistogram::NUM_BUCKETS;
+    while (b_first < LogHistogram::NUM_BUCKETS && all_latency.buckets[b_first] == 0)
+        ++b_first;
+    while (b_last > b_first && all_latency.buckets[b_last-1] == 0)
+        --b_last;
+    for (size_t b = b_first; b < b_last; b++) {
+        VecStat<uint64_t, DRAM_CHANNELS> cnt;
+        for (size_t i = 0; i < DRAM_CHANNELS; i++)
+            cnt[i] = channels_[i]->s_read_latency_hist_.buckets[b];
+        std::string name = "READ_LAT_HIST_[" + std::to_string(LogHistogram::bucket_lower_bound(b))
+                            + "," + std::to_string(LogHistogram::bucket_lower_bound(b+1)) + ")";
+        print_vecstat(out, "DRAM", name, cnt);
+    }
+
+    if constexpr (FAR_MEM_SIZE_MB > 0) {
+        uint64_t far_accesses = far_mem_->s_reads_ + far_mem_->s_writes_,
+                 near_accesses = 0;
+        for (size_t i = 0; i < DRAM_CHANNELS; i++)
+            near_accesses += vec_reads[i] + vec_writes[i];
+        double far_bandwidth = static_cast<double>(far_accesses * LINESIZE) / sim_time_ns,
+               far_fraction = mean(far_accesses, far_accesses + near_accesses),
+               rd_link_util = mean(far_mem_->s_reads_ * far_mem_->line_cycles_, static_cast<double>(GL_CYCLE)),
+               wr_link_util = mean(far_mem_->s_writes_ * far_mem_->line_cycles_, static_cast<double>(GL_CYCLE));
+
+        out << BAR << "\n";
+        print_stat(out, "FAR_MEM", "NUM_READS", far_mem_->s_reads_);
+        print_stat(out, "FAR_MEM", "NUM_WRITES", far_mem_->s_writes_);
+        print_stat(out, "FAR_MEM", "ACCESS_FRACTION", far_fraction);
+        print_stat(out, "FAR_MEM", "BANDWIDTH_GBPS", far_bandwidth);
+        print_stat(out, "FAR_MEM", "READ_LINK_UTILIZATION", rd_link_util);
+        print_stat(out, "FAR_MEM", "WRITE_LINK_UTILIZATION", wr_link_util);
+        print_stat(out, "FAR_MEM", "MIGRATION_LINES", s_migration_lines_);
+    }
+
+    if constexpr (DRAM_CACHE_SIZE_MB > 0) {
+        const DRAMCache& dc = *dram_cache_;
+        uint64_t cache_reads = 0,
+                 cache_writes = 0,
+                 cache_row_hits = 0;
+        for (const auto& ch : dc.channels_) {
+            cache_reads += ch->s_reads_;
+            cache_writes += ch->s_writes_;
+            cache_row_hits += ch->s_row_buffer_hits_;
+        }
+        uint64_t demand_reads = dc.s_read_hits_ + dc.s_read_misses_,
+                 demand_accesses = demand_reads + dc.s_write_hits_ + dc.s_write_misses_,
+                 device_accesses = cache_reads + cache_writes + dc.s_mem_reads_ + dc.s_mem_writes_;
+        // Bandwidth amplification is the number of lines moved (to or from the cache or
+        // memory) per request from the LLC.
+        double read_hit_rate = mean(dc.s_read_hits_, demand_reads),
+               write_hit_rate = mean(dc.s_write_hits_, dc.s_write_hits_ + dc.s_write_misses_),
+               hit_latency = mean(dc.s_tot_hit_latency_, dc.s_read_hits_),
+               miss_latency = mean(dc.s_tot_miss_latency_, dc.s_read_misses_),
+               cache_bandwidth = static_cast<double>((cache_reads + cache_writes) * LINESIZE) / sim_time_ns,
+               cache_rbhr = mean(cache_row_hits, cache_reads + cache_writes),
+               amplification = mean(device_accesses, demand_accesses);
+
+        out << BAR << "\n";
+        print_stat(out, "DRAM_CACHE", "READ_HITS", dc.s_read_hits_);
+        print_stat(out, "DRAM_CACHE", "READ_MISSES", dc.s_read_misses_);
+        print_stat(out, "DRAM_CACHE", "READ_HIT_RATE", read_hit_rate);
+        print_stat(out, "DRAM_CACHE", "WRITE_HIT_RATE", write_hit_rate);
+        print_stat(out, "DRAM_CACHE", "AVG_HIT_LATENCY", hit_latency);
+        print_stat(out, "DRAM_CACHE", "AVG_MISS_LATENCY", miss_latency);
+        print_stat(out, "DRAM_CACHE", "PROBES", dc.s_probes_);
+        print_stat(out, "DRAM_CACHE", "FILLS", dc.s_fills_);
+        print_stat(out, "DRAM_CACHE", "DIRTY_EVICTIONS", dc.s_dirty_evictions_);
+        if constexpr (DRAM_CACHE_TAGS == DRAMCacheTags::ALLOY && DRAM_CACHE_MISS_PREDICTOR) {
+            print_stat(out, "DRAM_CACHE", "PRED_ACCURACY", mean(dc.s_pred_correct_, demand_reads));
+            print_stat(out, "DRAM_CACHE", "PRED_MISS_BUT_HIT", dc.s_pred_miss_but_hit_);
+            print_stat(out, "DRAM_CACHE", "PRED_HIT_BUT_MISS", dc.s_pred_hit_but_miss_);
+        }
+        print_stat(out, "DRAM_CACHE", "CACHE_READS", cache_reads);
+        print_stat(out, "DRAM_CACHE", "CACHE_WRITES", cache_writes);
+        print_stat(out, "DRAM_CACHE", "CACHE_ROW_BUFFER_HIT_RATE", cache_rbhr);
+        print_stat(out, "DRAM_CACHE", "CACHE_BANDWIDTH_GBPS", cache_bandwidth);
+        print_stat(out, "DRAM_CACHE", "MEM_READS", dc.s_mem_reads_);
+        print_stat(out, "DRAM_CACHE", "MEM_WRITES", dc.s_mem_writes_);
+        print_stat(out, "DRAM_CACHE", "BANDWIDTH_AMPLIFICATION", amplification);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////
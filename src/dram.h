@@ -6,22 +6,36 @@
 #ifndef DRAM_h
 #define DRAM_h
 
+#include "constants.h"
+#include "transaction.h"
+
+#include <array>
+#include <deque>
+#include <iosfwd>
+#include <memory>
+#include <unordered_map>
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 /*
- * Defined in `transaction.h`
+ * Defined in `dram/channel.h` and `dram_timing.h`
+ * */
+template <class TIMING> class DRAMChannel;
+struct DRAMTiming;
+/*
+ * Defined in `dram/far_memory.h`
  * */
-class Transaction;
+class FarMemory;
 /*
- * Defined in `dram/channel.h`
+ * Defined in `dram/cache.h`
  * */
-class DRAMChannel;
+class DRAMCache;
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 /*
  * This class is merely a simple wrapper for managing multiple DRAM
- * channels.
+ * channels (and the far memory device and DRAM cache, if any).
  * */
 class DRAM
 {
@@ -38,14 +52,43 @@ public:
     };
 
     using io_ptr = std::unique_ptr<IO>;
-    using channel_ptr = std::unique_ptr<DRAMChannel>;
+    using channel_ptr = std::unique_ptr<DRAMChannel<DRAMTiming>>;
     using channel_array_t = std::array<channel_ptr, DRAM_CHANNELS>;
+    using far_mem_ptr = std::unique_ptr<FarMemory>;
+    using dram_cache_ptr = std::unique_ptr<DRAMCache>;
+    /*
+     * Number of accesses to each page frame (only for `MemPlacement::HOTNESS`).
+     * These are read and decayed by `PageMigrator` at the end of each epoch.
+     * */
+    using page_access_map_t = std::unordered_map<uint64_t, uint64_t>;
 
     io_ptr io_;
     channel_array_t channels_;
+    /*
+     * Page frames past the end of DRAM are in far memory (null if there is no far memory).
+     * */
+    far_mem_ptr far_mem_;
+    /*
+     * All requests from the LLC go through the DRAM cache (null if there is no DRAM cache).
+     * */
+    dram_cache_ptr dram_cache_;
+
+    page_access_map_t page_accesses_;
+    /*
+     * Number of lines copied (read and written) by page migrations.
+     * */
+    uint64_t s_migration_lines_ =0;
 
     const double freq_ghz_;
 private:
+    /*
+     * Pending accesses of page migrations: each line is copied by a `MIGRATION` read of
+     * the source line and a write to the destination line. At most one is issued per cycle.
+     * */
+    using migration_queue_t = std::deque<Transaction>;
+
+    migration_queue_t migration_queue_;
+
     double leap_ =0.0;
 
     const double clock_scale_;
@@ -53,10 +96,25 @@ public:
     DRAM(double cpu_freq_ghz, double freq_ghz);
     ~DRAM(void);
 
-    void warmup_access(uint64_t, bool) {}
+    void warmup_access(uint64_t, bool, uint64_t ip=0, uint8_t coreid=0) {}
 
     void tick(void);
     void print_stats(std::ostream&);
+    /*
+     * Copies the page frame `src_pfn` to `dst_pfn` (in either tier). The copy's
+     * accesses are attributed to core `coreid`.
+     * */
+    void migrate_page(uint64_t src_pfn, uint64_t dst_pfn, uint8_t coreid);
+    /*
+     * Sends the transaction to the channel or far memory device that holds its address,
+     * and marks its arrival time (for latency stats).
+     * */
+    bool route(Transaction);
+private:
+    /*
+     * Called when a memory read completes.
+     * */
+    void read_done(const Transaction&);
 };
 
 ////////////////////////////////////////////////////////////////////////////
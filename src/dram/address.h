@@ -12,6 +12,7 @@
 ////////////////////////////////////////////////////////////////////////////
 
 size_t dram_channel(uint64_t);
+size_t dram_subchannel(uint64_t);
 size_t dram_rank(uint64_t);
 size_t dram_bankgroup(uint64_t);
 size_t dram_bank(uint64_t);
@@ -26,19 +27,11 @@ size_t dram_row(uint64_t);
 #include "address/coffeelake.inl"
 #elif defined(DRAM_AM_SKYLAKE)
 #include "address/skylake.inl"
+#elif defined(DRAM_AM_MASK)
+#include "address/mask.inl"
 #endif
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
-inline size_t get_bank_idx(uint64_t addr)
-{
-    return dram_bank(addr) 
-            + dram_bankgroup(addr)*DRAM_BANKS 
-            + dram_rank(addr)*DRAM_BANKGROUPS*DRAM_BANKS;
-}
-
-////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////
-
 #endif  // DRAM_ADDRESS_h
@@ -0,0 +1,164 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Mask-programmable address mapping: bit `i` of a field is the parity of
+ * the address bits selected by the field's `i`-th mask (see `DRAM_AM_CH_MASKS`,
+ * etc. in `constants.h`). This supports XOR-based channel and bank hashing.
+ * */
+
+#include <array>
+
+template <size_t N> constexpr bool
+am_masks_are_contiguous(const std::array<uint64_t, N>& masks)
+{
+    for (size_t i = 0; i < N; i++) {
+        if (masks[i] != (masks[0] << i) || (masks[0] & (masks[0]-1)) != 0)
+            return false;
+    }
+    return true;
+}
+
+template <const auto& MASKS> inline size_t
+am_apply_masks(uint64_t x)
+{
+    constexpr size_t N = MASKS.size();
+    if constexpr (N == 0) {
+        return 0;
+    } else if constexpr (am_masks_are_contiguous(MASKS)) {
+        // Common case for rows: no hashing, so this is a shift.
+        return (x >> __builtin_ctzll(MASKS[0])) & ((1ull << N) - 1);
+    } else {
+        size_t out = 0;
+        for (size_t i = 0; i < N; i++)
+            out |= static_cast<size_t>(__builtin_parityll(x & MASKS[i])) << i;
+        return out;
+    }
+}
+
+inline size_t dram_channel(uint64_t x)
+{
+    return am_apply_masks<DRAM_AM_CH_MASKS>(x);
+}
+
+inline size_t dram_subchannel(uint64_t x)
+{
+    return am_apply_masks<DRAM_AM_SC_MASKS>(x);
+}
+
+inline size_t dram_bankgroup(uint64_t x)
+{
+    return am_apply_masks<DRAM_AM_BG_MASKS>(x);
+}
+
+inline size_t dram_bank(uint64_t x)
+{
+    return am_apply_masks<DRAM_AM_BA_MASKS>(x);
+}
+
+inline size_t dram_rank(uint64_t x)
+{
+    return am_apply_masks<DRAM_AM_RA_MASKS>(x);
+}
+
+inline size_t dram_row(uint64_t x)
+{
+    return am_apply_masks<DRAM_AM_ROW_MASKS>(x);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#include "globals.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+/*
+ * The first line labels each address bit with the field it belongs to (the row
+ * takes precedence, and unused bits below the row are column bits). The following
+ * lines show each hashed channel/sub-channel/rank/bankgroup/bank bit's mask.
+ * */
+inline void
+print_address_mapping(std::ostream& out)
+{
+    constexpr size_t LINE_OFF = numeric_traits<LINESIZE>::log2;
+
+    auto or_masks = [] (const auto& masks)
+    {
+        uint64_t m = 0;
+        for (uint64_t x : masks)
+            m |= x;
+        return m;
+    };
+    const uint64_t ch = or_masks(DRAM_AM_CH_MASKS),
+                   sc = or_masks(DRAM_AM_SC_MASKS),
+                   ra = or_masks(DRAM_AM_RA_MASKS),
+                   bg = or_masks(DRAM_AM_BG_MASKS),
+                   ba = or_masks(DRAM_AM_BA_MASKS),
+                   row = or_masks(DRAM_AM_ROW_MASKS);
+    const uint64_t all = ch | sc | ra | bg | ba | row;
+
+    out << "Address Mapping:\n" << BAR << "\n";
+    for (size_t i = 0; i <= 48; i += 6) {
+        out << std::setw(18) << std::left << i;
+    }
+    out << "\n";
+    for (size_t i = 0; i < 48; i++) {
+        if (i < LINE_OFF)
+            out << ".  ";
+        else if (i < numeric_traits<PAGESIZE>::log2)
+            out << "li ";
+        else
+            out << "pg ";
+    }
+    out << "\n";
+    // Field of each bit.
+    for (size_t i = 0; i < LINE_OFF; i++)
+        out << ".  ";
+    for (size_t i = 0; i < 48 - LINE_OFF; i++) {
+        uint64_t b = 1ull << i;
+        if (row & b)
+            out << "ro ";
+        else if (ch & b)
+            out << "ch ";
+        else if (sc & b)
+            out << "sc ";
+        else if (ra & b)
+            out << "ra ";
+        else if (bg & b)
+            out << "bg ";
+        else if (ba & b)
+            out << "ba ";
+        else if (b < all)
+            out << "co ";
+    }
+    out << "\n";
+    // Masks of each hashed bit.
+    auto print_masks = [LINE_OFF, &out] (std::string name, const auto& masks)
+    {
+        for (size_t j = 0; j < masks.size(); j++) {
+            if ((masks[j] & (masks[j]-1)) == 0)
+                continue;  // Not hashed.
+            std::string label = name + std::to_string(j);
+            out << std::setw(3*LINE_OFF) << std::left << label;
+            for (size_t i = 0; i < 48 - LINE_OFF; i++)
+                out << (((masks[j] >> i) & 1) ? "x  " : "   ");
+            out << "\n";
+        }
+    };
+    print_masks("ch", DRAM_AM_CH_MASKS);
+    print_masks("sc", DRAM_AM_SC_MASKS);
+    print_masks("ra", DRAM_AM_RA_MASKS);
+    print_masks("bg", DRAM_AM_BG_MASKS);
+    print_masks("ba", DRAM_AM_BA_MASKS);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
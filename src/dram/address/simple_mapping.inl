@@ -7,7 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////
 
 /*
- * Provided that `CH_OFF`, `BG_OFF`, etc. are defined,
+ * Provided that `CH_OFF`, `SC_OFF`, `BG_OFF`, etc. are defined,
  * and all these bits are contiguous (column bits need not
  * be contiguous), this file will provide appropriate
  * address mapping functions.
@@ -20,6 +20,11 @@ inline size_t dram_channel(uint64_t x)
     return (x >> CH_OFF) & mask(DRAM_CHANNELS);
 }
 
+inline size_t dram_subchannel(uint64_t x)
+{
+    return (x >> SC_OFF) & mask(DRAM_SUBCHANNELS);
+}
+
 inline size_t dram_bankgroup(uint64_t x)
 {
     return (x >> BG_OFF) & mask(DRAM_BANKGROUPS); 
@@ -70,8 +75,9 @@ print_address_mapping(std::ostream& out)
     out << "\n";
     // Now print out parts of dram address mapping.
     std::unordered_set<size_t> endpoints{
-        CH_OFF, RA_OFF, BG_OFF, BA_OFF, ROW_OFF,
+        CH_OFF, SC_OFF, RA_OFF, BG_OFF, BA_OFF, ROW_OFF,
         CH_OFF+numeric_traits<DRAM_CHANNELS>::log2,
+        SC_OFF+numeric_traits<DRAM_SUBCHANNELS>::log2,
         RA_OFF+numeric_traits<DRAM_RANKS>::log2,
         BG_OFF+numeric_traits<DRAM_BANKGROUPS>::log2,
         BA_OFF+numeric_traits<DRAM_BANKS>::log2,
@@ -83,6 +89,8 @@ print_address_mapping(std::ostream& out)
     for (size_t i = 0; i < 48 - numeric_traits<LINESIZE>::log2; i++) {
         if (BETWEEN(i, CH_OFF, DRAM_CHANNELS))
             out << "ch ";
+        else if (BETWEEN(i, SC_OFF, DRAM_SUBCHANNELS))
+            out << "sc ";
         else if (BETWEEN(i, RA_OFF, DRAM_RANKS))
             out << "ra ";
         else if (BETWEEN(i, BG_OFF, DRAM_BANKGROUPS))
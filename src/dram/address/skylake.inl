@@ -1,5 +1,6 @@
 constexpr size_t CH_OFF = 1;
-constexpr size_t BG_OFF = numeric_traits<DRAM_COLUMNS>::log2 + numeric_traits<DRAM_CHANNELS>::log2;
+constexpr size_t SC_OFF = numeric_traits<DRAM_COLUMNS>::log2 + numeric_traits<DRAM_CHANNELS>::log2;
+constexpr size_t BG_OFF = SC_OFF + numeric_traits<DRAM_SUBCHANNELS>::log2;
 constexpr size_t BA_OFF = BG_OFF + numeric_traits<DRAM_BANKGROUPS>::log2;
 constexpr size_t RA_OFF = BA_OFF + numeric_traits<DRAM_BANKS>::log2;
 constexpr size_t ROW_OFF = RA_OFF + numeric_traits<DRAM_RANKS>::log2;
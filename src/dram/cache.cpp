@@ -0,0 +1,254 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#include "memsys.h"
+
+#include "dram.h"
+#include "dram_timing.h"
+#include "dram/cache.h"
+#include "dram/channel.h"
+#include "io_bus.h"
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+DRAMCache::DRAMCache(DRAM* dram, double freq_ghz, double cpu_freq_ghz)
+    :dram_(dram),
+    tags_(NUM_LINES)
+{
+    for (size_t i = 0; i < DRAM_CACHE_CHANNELS; i++)
+        channels_[i] = channel_ptr(new DRAMChannel<DRAMCacheTiming>(freq_ghz, cpu_freq_ghz));
+}
+
+DRAMCache::~DRAMCache() {}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+bool
+DRAMCache::add_incoming(Transaction t)
+{
+    size_t num_pending = cache_waiters_.size() + misses_.size() + mem_ops_.size()
+                            + cache_rd_ops_.size() + cache_wr_ops_.size();
+    if (num_pending >= DRAM_CACHE_QUEUE_SIZE)
+        return false;
+
+    const uint64_t line = t.address;
+    const size_t set = fast_mod<NUM_SETS>(line);
+    size_t way = find_way(set, line);
+    bool is_hit = way < DRAM_CACHE_WAYS;
+
+    if (!trans_is_read(t.type)) {
+        if (is_hit) {
+            ++s_write_hits_;
+            tags_[set*DRAM_CACHE_WAYS + way].dirty = true;
+            tags_[set*DRAM_CACHE_WAYS + way].last_use = GL_CYCLE;
+        } else {
+            ++s_write_misses_;
+            way = install(set, line, true, t.coreid);
+        }
+        uint64_t slot = set*DRAM_CACHE_WAYS + way;
+        if constexpr (DRAM_CACHE_TAGS == DRAMCacheTags::ALLOY) {
+            // Need to read the set to check its tag before overwriting it.
+            ++s_probes_;
+            add_cache_op(TransactionType::READ, slot, t.coreid);
+            add_cache_op(TransactionType::WRITE, slot, t.coreid);
+        } else {
+            add_cache_op(TransactionType::WRITE, slot, t.coreid, DRAM_CACHE_TAG_LATENCY);
+        }
+        return true;
+    }
+
+    // The line is already on its way from memory.
+    if (misses_.count(line))
+        return true;
+
+    if (is_hit) {
+        ++s_read_hits_;
+        tags_[set*DRAM_CACHE_WAYS + way].last_use = GL_CYCLE;
+    } else {
+        ++s_read_misses_;
+        way = install(set, line, false, t.coreid);
+    }
+    uint64_t slot = set*DRAM_CACHE_WAYS + way;
+
+    if constexpr (DRAM_CACHE_TAGS == DRAMCacheTags::ALLOY) {
+        bool pred_miss = false;
+        if constexpr (USE_MISS_PREDICTOR) {
+            uint8_t& ctr = pred_entry(t.coreid, line);
+            pred_miss = ctr >= PRED_MISS_THRESHOLD;
+            if (pred_miss == !is_hit)
+                ++s_pred_correct_;
+            else if (pred_miss)
+                ++s_pred_miss_but_hit_;
+            else
+                ++s_pred_hit_but_miss_;
+            if (is_hit && ctr > 0)
+                --ctr;
+            else if (!is_hit && ctr < PRED_MAX)
+                ++ctr;
+        }
+        // A predicted miss goes to memory without waiting for the probe.
+        if (pred_miss)
+            add_mem_op(TransactionType::READ, line, t.coreid);
+        if (!is_hit) {
+            ++s_probes_;
+            misses_[line] = MissEntry{slot, t.coreid, pred_miss, GL_CYCLE};
+        }
+        cache_waiters_.emplace(slot, CacheWaiter{line, t.coreid, is_hit, GL_CYCLE});
+        add_cache_op(TransactionType::READ, slot, t.coreid);
+    } else {
+        if (is_hit) {
+            cache_waiters_.emplace(slot, CacheWaiter{line, t.coreid, true, GL_CYCLE});
+            add_cache_op(TransactionType::READ, slot, t.coreid, DRAM_CACHE_TAG_LATENCY);
+        } else {
+            misses_[line] = MissEntry{slot, t.coreid, true, GL_CYCLE};
+            add_mem_op(TransactionType::READ, line, t.coreid, DRAM_CACHE_TAG_LATENCY);
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+DRAMCache::tick()
+{
+    issue_cache_ops(cache_rd_ops_);
+    issue_cache_ops(cache_wr_ops_);
+    while (!mem_ops_.empty() && GL_CYCLE >= mem_ops_.front().cycle_ready) {
+        if (!dram_->route(mem_ops_.front().trans))
+            break;
+        mem_ops_.pop_front();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+DRAMCache::cache_read_done(uint64_t slot)
+{
+    auto [begin, end] = cache_waiters_.equal_range(slot);
+    for (auto it = begin; it != end; it++) {
+        const CacheWaiter& w = it->second;
+        if (w.is_hit) {
+            s_tot_hit_latency_ += GL_CYCLE - w.cycle_arrived;
+            send_to_llc(w.line);
+        } else {
+            // The probe found a miss: go to memory if we have not already.
+            auto m_it = misses_.find(w.line);
+            if (m_it != misses_.end() && !m_it->second.mem_read_sent) {
+                add_mem_op(TransactionType::READ, w.line, w.coreid);
+                m_it->second.mem_read_sent = true;
+            }
+        }
+    }
+    cache_waiters_.erase(begin, end);
+}
+
+void
+DRAMCache::mem_read_done(uint64_t line)
+{
+    // Reads for mispredicted misses have no entry.
+    auto it = misses_.find(line);
+    if (it == misses_.end())
+        return;
+    const MissEntry& e = it->second;
+    s_tot_miss_latency_ += GL_CYCLE - e.cycle_arrived;
+    send_to_llc(line);
+    // Fill the line unless it was evicted while waiting on memory.
+    const TagEntry& tag = tags_[e.slot];
+    if (tag.valid && tag.line == line) {
+        ++s_fills_;
+        add_cache_op(TransactionType::WRITE, e.slot, e.coreid);
+    }
+    misses_.erase(it);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+DRAMCache::find_way(size_t set, uint64_t line) const
+{
+    for (size_t i = 0; i < DRAM_CACHE_WAYS; i++) {
+        const TagEntry& e = tags_[set*DRAM_CACHE_WAYS + i];
+        if (e.valid && e.line == line)
+            return i;
+    }
+    return DRAM_CACHE_WAYS;
+}
+
+size_t
+DRAMCache::install(size_t set, uint64_t line, bool dirty, uint8_t coreid)
+{
+    // Pick an invalid way, or the LRU way.
+    size_t way = 0;
+    for (size_t i = 0; i < DRAM_CACHE_WAYS; i++) {
+        const TagEntry& e = tags_[set*DRAM_CACHE_WAYS + i];
+        if (!e.valid) {
+            way = i;
+            break;
+        }
+        if (e.last_use < tags_[set*DRAM_CACHE_WAYS + way].last_use)
+            way = i;
+    }
+    uint64_t slot = set*DRAM_CACHE_WAYS + way;
+    TagEntry& victim = tags_[slot];
+    if (victim.valid && victim.dirty) {
+        ++s_dirty_evictions_;
+        // `ALLOY` reads the victim with the probe, but `SRAM` must read it separately.
+        if constexpr (DRAM_CACHE_TAGS == DRAMCacheTags::SRAM)
+            add_cache_op(TransactionType::READ, slot, coreid, DRAM_CACHE_TAG_LATENCY);
+        add_mem_op(TransactionType::WRITE, victim.line, coreid);
+    }
+    victim = TagEntry{line, true, dirty, GL_CYCLE};
+    return way;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+DRAMCache::add_cache_op(TransactionType type, uint64_t slot, uint8_t coreid, uint64_t delay)
+{
+    op_queue_t& q = trans_is_read(type) ? cache_rd_ops_ : cache_wr_ops_;
+    q.push_back(Op{Transaction(coreid, nullptr, type, slot), GL_CYCLE+delay});
+}
+
+void
+DRAMCache::issue_cache_ops(op_queue_t& q)
+{
+    while (!q.empty() && GL_CYCLE >= q.front().cycle_ready) {
+        Transaction& t = q.front().trans;
+        t.dram_cycle_arrived = GL_DRAM_CYCLE;
+        auto& ch = channels_[DRAMCacheTiming::channel(t.address)];
+        if (!ch->io_->add_incoming(t))
+            break;
+        ch->wake();
+        q.pop_front();
+    }
+}
+
+void
+DRAMCache::add_mem_op(TransactionType type, uint64_t line, uint8_t coreid, uint64_t delay)
+{
+    if (trans_is_read(type))
+        ++s_mem_reads_;
+    else
+        ++s_mem_writes_;
+    mem_ops_.push_back(Op{Transaction(coreid, nullptr, type, line), GL_CYCLE+delay});
+}
+
+void
+DRAMCache::send_to_llc(uint64_t line)
+{
+    GL_LLC->mark_load_as_done(line);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,196 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef DRAM_CACHE_h
+#define DRAM_CACHE_h
+
+#include "constants.h"
+#include "globals.h"
+#include "transaction.h"
+#include "util/numerics.h"
+#include "util/stats.h"
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Defined in `dram.h`, `dram/channel.h`, and `dram_timing.h`
+ * */
+class DRAM;
+template <class TIMING> class DRAMChannel;
+struct DRAMCacheTiming;
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * `ALLOY`: the cache is direct-mapped, and each tag is stored with its data (Qureshi and
+ *          Loh, MICRO 2012), so every access must read the line from the cache to check
+ *          the tag. A miss predictor can send predicted misses to memory in parallel.
+ * `SRAM`: tags are kept on-chip and checked in `DRAM_CACHE_TAG_LATENCY` cycles, so misses
+ *          go directly to memory.
+ * */
+enum class DRAMCacheTags { ALLOY, SRAM };
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * A memory-side DRAM cache (i.e., HBM as a cache) between the LLC and memory. The cache
+ * has its own `DRAMChannel`s (with its own organization and timing, see `DRAMCacheTiming`),
+ * and its lines are stored at device address `set*DRAM_CACHE_WAYS + way`.
+ *
+ * The cache is write-allocate: LLC writebacks are installed as dirty lines, and dirty
+ * victims are written back to memory. Misses are filled when memory returns the line.
+ * */
+class DRAMCache
+{
+public:
+    using channel_ptr = std::unique_ptr<DRAMChannel<DRAMCacheTiming>>;
+    using channel_array_t = std::array<channel_ptr, DRAM_CACHE_CHANNELS>;
+
+    uint64_t s_read_hits_ =0;
+    uint64_t s_read_misses_ =0;
+    uint64_t s_write_hits_ =0;
+    uint64_t s_write_misses_ =0;
+    /*
+     * Reads of the cache that only check a tag (all `ALLOY` misses and writes).
+     * */
+    uint64_t s_probes_ =0;
+    uint64_t s_fills_ =0;
+    uint64_t s_dirty_evictions_ =0;
+    /*
+     * Number of memory reads and writes sent by the cache.
+     * */
+    uint64_t s_mem_reads_ =0;
+    uint64_t s_mem_writes_ =0;
+    /*
+     * Miss predictor stats (for `ALLOY`): predicted misses that hit waste memory
+     * bandwidth, and predicted hits that miss wait for the probe.
+     * */
+    uint64_t s_pred_correct_ =0;
+    uint64_t s_pred_miss_but_hit_ =0;
+    uint64_t s_pred_hit_but_miss_ =0;
+    /*
+     * Total latency (in CPU cycles) of demand reads that hit or missed.
+     * */
+    uint64_t s_tot_hit_latency_ =0;
+    uint64_t s_tot_miss_latency_ =0;
+
+    channel_array_t channels_;
+
+    constexpr static size_t NUM_LINES = DRAM_CACHE_SIZE_MB*1024*1024 / LINESIZE;
+    constexpr static size_t NUM_SETS = NUM_LINES / DRAM_CACHE_WAYS;
+private:
+    constexpr static bool USE_MISS_PREDICTOR = DRAM_CACHE_MISS_PREDICTOR && (DRAM_CACHE_TAGS == DRAMCacheTags::ALLOY);
+    /*
+     * The miss predictor has a table of 3-bit counters per core, indexed by page
+     * (similar to MAP-I, but indexed by page as we do not know the instruction address).
+     * */
+    constexpr static size_t PRED_ENTRIES = 256;
+    constexpr static uint8_t PRED_MAX = 7;
+    constexpr static uint8_t PRED_MISS_THRESHOLD = 4;
+
+    struct TagEntry
+    {
+        uint64_t line;
+        bool     valid =false;
+        bool     dirty =false;
+        uint64_t last_use =0;
+    };
+    /*
+     * A demand read waiting on a read of the cache. If `is_hit` is false, this
+     * is an `ALLOY` probe that found a miss.
+     * */
+    struct CacheWaiter
+    {
+        uint64_t line;
+        uint8_t  coreid;
+        bool     is_hit;
+        uint64_t cycle_arrived;
+    };
+    /*
+     * A miss waiting on memory. `mem_read_sent` is set once the memory read is sent (it may
+     * be sent before the probe returns if a miss was predicted).
+     * */
+    struct MissEntry
+    {
+        uint64_t slot;
+        uint8_t  coreid;
+        bool     mem_read_sent;
+        uint64_t cycle_arrived;
+    };
+    /*
+     * An access to send to the cache or memory once `cycle_ready` is reached. Reads and
+     * writes of the cache are queued separately, so fills that are blocked on a full
+     * write queue do not hold back hits.
+     * */
+    struct Op
+    {
+        Transaction trans;
+        uint64_t    cycle_ready;
+    };
+
+    using tag_array_t = std::vector<TagEntry>;
+    using cache_waiter_map_t = std::unordered_multimap<uint64_t, CacheWaiter>;
+    using miss_map_t = std::unordered_map<uint64_t, MissEntry>;
+    using op_queue_t = std::deque<Op>;
+    using pred_table_t = std::array<uint8_t, NUM_THREADS*PRED_ENTRIES>;
+
+    DRAM* dram_;
+
+    tag_array_t        tags_;
+    cache_waiter_map_t cache_waiters_;
+    miss_map_t         misses_;
+    op_queue_t         cache_rd_ops_;
+    op_queue_t         cache_wr_ops_;
+    op_queue_t         mem_ops_;
+    pred_table_t       pred_{};
+public:
+    DRAMCache(DRAM*, double freq_ghz, double cpu_freq_ghz);
+    ~DRAMCache(void);
+    /*
+     * Accepts a request from the LLC. Returns false if too many accesses are pending.
+     * */
+    bool add_incoming(Transaction);
+    /*
+     * Sends pending accesses to the cache channels and memory. Does not tick the channels.
+     * */
+    void tick(void);
+    /*
+     * Called when a read of the cache (at device address `slot`) or of memory completes.
+     * */
+    void cache_read_done(uint64_t slot);
+    void mem_read_done(uint64_t line);
+private:
+    /*
+     * Returns the way holding `line` in `set`, or `DRAM_CACHE_WAYS` if it is not present.
+     * */
+    size_t find_way(size_t set, uint64_t line) const;
+    /*
+     * Installs `line` in `set` (replacing the LRU way), and writes back the victim if it
+     * is dirty. Returns the way.
+     * */
+    size_t install(size_t set, uint64_t line, bool dirty, uint8_t coreid);
+
+    void add_cache_op(TransactionType, uint64_t slot, uint8_t coreid, uint64_t delay=0);
+    void issue_cache_ops(op_queue_t&);
+    void add_mem_op(TransactionType, uint64_t line, uint8_t coreid, uint64_t delay=0);
+    void send_to_llc(uint64_t line);
+
+    inline uint8_t& pred_entry(uint8_t coreid, uint64_t line)
+    {
+        uint64_t page = line >> numeric_traits<PAGESIZE/LINESIZE>::log2;
+        return pred_[coreid*PRED_ENTRIES + fast_mod<PRED_ENTRIES>(page ^ (page >> 8))];
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // DRAM_CACHE_h
@@ -7,23 +7,44 @@
 #define DRAM_CHANNEL_h
 
 #include "constants.h"
+#include "dram_power.h"
+#include "globals.h"
+#include "io_bus.h"
 #include "transaction.h"
+#include "util/numerics.h"
+#include "util/stats.h"
 
 #include <array>
 #include <deque>
 #include <optional>
+#include <utility>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
+
 /*
- * Defined in `io_bus.h`
+ * `OPEN`: rows are only closed on a row miss (or refresh).
+ * `CLOSE`: all CAS commands auto-precharge.
+ * `TIMEOUT`: rows with no pending hits are closed after `DRAM_PAGE_TIMEOUT` idle cycles.
+ * `PREDICTIVE`: a per-bank predictor decides whether to auto-precharge the last
+ *              pending row hit.
  * */
-class IOBus;
-
-////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////
-
-enum class DRAMPagePolicy { OPEN, CLOSE };
+enum class DRAMPagePolicy { OPEN, CLOSE, TIMEOUT, PREDICTIVE };
+/*
+ * `ALL_BANK`: all banks in the channel are refreshed together (REFab).
+ * `SAME_BANK`: the same bank in every bankgroup of a rank is refreshed together (REFsb).
+ * `PER_BANK`: a single bank is refreshed at a time (REFpb).
+ * */
+enum class DRAMRefreshMode { ALL_BANK, SAME_BANK, PER_BANK };
+/*
+ * `FRFCFS`: row hits first, then oldest first (banks are visited round-robin).
+ * `BLISS`: cores that are served too many requests in a row are blacklisted
+ *          and deprioritized (Subramanian et al., ICCD 2014).
+ * `PARBS`: requests are marked in batches, and marked requests are prioritized,
+ *          with cores ranked by shortest job first (Mutlu and Moscibroda, ISCA 2008).
+ * */
+enum class DRAMScheduler { FRFCFS, BLISS, PARBS };
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -65,6 +86,19 @@ struct DRAMCommand
     Transaction trans;
     DRAMCommandType type;
     bool is_row_buffer_hit =true;
+    /*
+     * Metadata for scheduling and per-core stats:
+     *  `cycle_enqueued` is when the command entered a bank's command queue,
+     *  `interference` is the number of cycles the command's bank was busy with
+     *      other cores' commands while this command waited, and
+     *  `marked` is set if the command is in the current PAR-BS batch, and
+     *  `cycle_row_cmd` is when the first PRE or ACT was issued for the command
+     *      (0 if it was a row buffer hit).
+     * */
+    uint64_t cycle_enqueued;
+    uint64_t interference =0;
+    bool     marked =false;
+    uint64_t cycle_row_cmd =0;
 
     DRAMCommand(void);
     DRAMCommand(uint64_t addr, DRAMCommandType);
@@ -83,15 +117,64 @@ struct DRAMBank
     size_t num_cas_to_open_row_ =0;
 
     cmd_queue_t cmd_queue_;
+    /*
+     * Set when the bank's refresh is due. The bank cannot be
+     * selected by FRFCFS until the refresh is done.
+     * */
+    bool ref_pending_ =false;
+    /*
+     * Number of entries in `cmd_queue_` that hit in `open_row_`. This is
+     * maintained on enqueue, CAS, ACT, and PRE so FRFCFS need not rescan the queue.
+     * */
+    size_t num_row_hits_ =0;
+
+    /*
+     * Adaptive page policy state: `last_cas_cycle_` is used by `TIMEOUT`, and
+     * `row_hit_ctr_` is a 2-bit counter (used by `PREDICTIVE`) that predicts whether
+     * the open row will be hit again. `closed_row_` is the row last closed by the
+     * page policy (not by a row miss or refresh), used to detect premature precharges.
+     * */
+    uint64_t last_cas_cycle_ =0;
+    uint8_t  row_hit_ctr_ =2;
+    row_t    closed_row_;
 
     uint64_t act_ok_cycle_ =0;
     uint64_t pre_ok_cycle_ =0;
     uint64_t cas_ok_cycle_ =0;
+    /*
+     * Earliest cycle at which any command this bank could select (ACT, PRE, or
+     * a row hit CAS) meets the bank-level timing constraints.
+     * */
+    uint64_t issue_ok_cycle_ =0;
 };
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
+/*
+ * Energy breakdown of a channel (in pJ). See `DRAMChannel::compute_energy`.
+ * */
+struct DRAMEnergy
+{
+    double act =0.0;
+    double rd =0.0;
+    double wr =0.0;
+    double ref =0.0;
+    double act_stby =0.0;
+    double pre_stby =0.0;
+
+    inline double total(void) const
+    {
+        return act + rd + wr + ref + act_stby + pre_stby;
+    }
+};
 
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * `TIMING` gives the device's organization, address mapping, and timings (see
+ * `DRAMTiming` and `DRAMCacheTiming` in `dram_timing.h`).
+ * */
+template <class TIMING>
 class DRAMChannel
 {
 public:
@@ -103,41 +186,220 @@ public:
     uint64_t s_activates_ =0;
     uint64_t s_refreshes_ =0;
     uint64_t s_pre_demand_ =0;
+    /*
+     * Premature: the page policy closed a row that was activated again next.
+     * Late: a row miss had to precharge a row with no pending hits.
+     * */
+    uint64_t s_pre_premature_ =0;
+    uint64_t s_pre_late_ =0;
+    /*
+     * Number of CAS commands to a different rank than the previous CAS.
+     * */
+    uint64_t s_rank_switches_ =0;
 
     uint64_t s_row_buffer_hits_ =0;
+    /*
+     * Number of cycles where at least one bank is open (active standby),
+     * or all banks are closed (precharge standby).
+     * */
+    uint64_t s_act_stby_cycles_ =0;
+    uint64_t s_pre_stby_cycles_ =0;
+    /*
+     * Per-core stats: number of CAS commands, total cycles spent in the command
+     * queues, and total cycles of interference from other cores.
+     * */
+    using core_stat_t = VecStat<uint64_t, NUM_THREADS>;
+
+    core_stat_t s_core_cas_{};
+    core_stat_t s_core_queue_latency_{};
+    core_stat_t s_core_interference_{};
+    /*
+     * Data bus stats: cycles the data bus is transferring data, and cycles it
+     * is idle while there are queued requests (see `update_bus_stats`). Both are
+     * summed over sub-channels.
+     * */
+    uint64_t s_data_bus_busy_cycles_ =0;
+    uint64_t s_data_bus_idle_queued_cycles_ =0;
+    /*
+     * Read latency breakdown (in DRAM cycles), recorded when a read's CAS issues:
+     *  `s_rq_wait_hist_`: time in `io_`'s read queue,
+     *  `s_cmdq_wait_hist_`: time in the bank's command queue before its first command,
+     *  `s_row_miss_hist_`: time from the first PRE/ACT to the CAS (row misses only), and
+     *  `s_read_latency_hist_`: time from arrival to the end of the data burst.
+     * */
+    LogHistogram s_rq_wait_hist_;
+    LogHistogram s_cmdq_wait_hist_;
+    LogHistogram s_row_miss_hist_;
+    LogHistogram s_read_latency_hist_;
 
     io_ptr io_;
+    /*
+     * `tick` does nothing before this cycle (unless a new transaction arrives,
+     * see `wake`), so the caller may skip it.
+     * */
+    uint64_t next_event_cycle_ =0;
 
     const double freq_ghz_;
 private:
-    constexpr static size_t TOT_BANKS = DRAM_RANKS*DRAM_BANKGROUPS*DRAM_BANKS;
+    /*
+     * Each sub-channel has its own ranks, banks, and data bus, but all
+     * sub-channels share the channel's command bus (and `io_`). A "rank unit"
+     * is a rank of a sub-channel, and banks are indexed by rank unit first.
+     * */
+    constexpr static size_t NUM_RANK_UNITS = TIMING::SUBCHANNELS*TIMING::RANKS;
+    constexpr static size_t BANKS_PER_RANK = TIMING::BANKGROUPS*TIMING::BANKS;
+    constexpr static size_t TOT_BANKS = NUM_RANK_UNITS*BANKS_PER_RANK;
+
+    constexpr static size_t BANK_MASK_WIDTH = (TOT_BANKS+63)/64;
+    /*
+     * Number of groups of banks that are refreshed together. Groups are refreshed
+     * in round-robin order, so all banks are refreshed once every `tREFI`. Ranks
+     * are refreshed separately (and staggered).
+     * */
+    constexpr static size_t REF_GROUPS = 
+        (DRAM_REFRESH_MODE == DRAMRefreshMode::ALL_BANK) ? NUM_RANK_UNITS
+        : (DRAM_REFRESH_MODE == DRAMRefreshMode::SAME_BANK) ? NUM_RANK_UNITS*TIMING::BANKS
+        : TOT_BANKS;
+
+    constexpr static uint64_t tRFC_GROUP = (DRAM_REFRESH_MODE == DRAMRefreshMode::ALL_BANK) ? TIMING::tRFC
+                                            : (DRAM_REFRESH_MODE == DRAMRefreshMode::SAME_BANK) ? TIMING::tRFCsb
+                                            : TIMING::tRFCpb;
+    constexpr static size_t BL = TIMING::BL;
+
+    constexpr static DRAMCommandType READ_CMD = (DRAM_PAGE_POLICY == DRAMPagePolicy::CLOSE)
+                                                    ? DRAMCommandType::READ_PRECHARGE
+                                                    : DRAMCommandType::READ;
+    constexpr static DRAMCommandType WRITE_CMD = (DRAM_PAGE_POLICY == DRAMPagePolicy::CLOSE)
+                                                    ? DRAMCommandType::WRITE_PRECHARGE
+                                                    : DRAMCommandType::WRITE;
+    /*
+     * Scheduler parameters (from the respective papers).
+     * */
+    constexpr static size_t   BLISS_THRESHOLD = 4;
+    constexpr static uint64_t BLISS_CLEAR_INTERVAL = 10'000;
+    constexpr static size_t   PARBS_MARKING_CAP = 5;
+    /*
+     * Maximum number of CAS commands in a row FRFCFS serves from one rank
+     * before considering other ranks.
+     * */
+    constexpr static size_t RANK_STREAK_CAP = 16;
 
     using bank_array_t = std::array<DRAMBank, TOT_BANKS>;
+    using bank_mask_t = std::array<uint64_t, BANK_MASK_WIDTH>;
     using constraint_t = std::array<uint64_t, 2>;
     using faw_t = std::deque<uint64_t>;
+    using rank_constraint_t = std::array<constraint_t, NUM_RANK_UNITS>;
+    using rank_faw_t = std::array<faw_t, NUM_RANK_UNITS>;
+    using rank_size_array_t = std::array<size_t, NUM_RANK_UNITS>;
+    using ref_group_t = std::vector<size_t>;
+    using ref_group_array_t = std::array<ref_group_t, REF_GROUPS>;
 
     bank_array_t banks_; 
     size_t next_bank_with_cmd_ =0;
     /*
-     * Channel-level timing constraints
+     * Bitmap of banks with a non-empty `cmd_queue_`. FRFCFS only visits
+     * these banks.
+     * */
+    bank_mask_t banks_with_cmd_{};
+    /*
+     * Bitmap of banks with an open row. Only maintained for the `TIMEOUT` policy.
+     * */
+    bank_mask_t banks_open_{};
+    /*
+     * Channel-level timing constraints, per rank unit.
      * First element is different bankgroup timing, second is same bankgroup.
+     * CAS commands to other ranks in the same sub-channel also update these
+     * (with rank switch timings).
      * */
-    constraint_t act_ok_cycle_{{0,0}}; 
-    constraint_t rd_ok_cycle_{{0,0}};
-    constraint_t wr_ok_cycle_{{0,0}};
-    faw_t faw_;
+    rank_constraint_t act_ok_cycle_{}; 
+    rank_constraint_t rd_ok_cycle_{};
+    rank_constraint_t wr_ok_cycle_{};
+    rank_faw_t        faw_;
 
-    size_t last_bankgroup_ =0;
+    rank_size_array_t last_bankgroup_{};
     /*
-     * Refresh management.
+     * Rank unit of the last CAS, and the number of CAS commands in a row to it.
+     * FRFCFS prefers this rank unit (up to `RANK_STREAK_CAP` commands) to avoid
+     * rank switch bubbles. `last_cas_rank_in_sc_` is the rank of the last CAS
+     * in each sub-channel.
      * */
-    uint64_t next_ref_cycle_;
-    uint64_t ref_done_cycle_ =0;
+    using sc_size_array_t = std::array<size_t, TIMING::SUBCHANNELS>;
+
+    size_t          last_cas_rank_ =0;
+    size_t          rank_cas_streak_ =0;
+    sc_size_array_t last_cas_rank_in_sc_{};
+    /*
+     * Refresh management. `ref_groups_` holds the bank indices of each
+     * refresh group.
+     * */
+    ref_group_array_t ref_groups_;
+    size_t            next_ref_group_ =0;
+    uint64_t          next_ref_cycle_;
+    /*
+     * BLISS state: a core is blacklisted once it has been served
+     * `BLISS_THRESHOLD` requests in a row. The blacklist is periodically cleared.
+     * */
+    using core_flag_array_t = std::array<bool, NUM_THREADS>;
+    using core_rank_array_t = std::array<size_t, NUM_THREADS>;
+
+    core_flag_array_t bliss_blacklist_{};
+    size_t            bliss_last_core_ =0;
+    size_t            bliss_streak_ =0;
+    uint64_t          bliss_next_clear_cycle_ =0;
+    /*
+     * PAR-BS state: `parbs_rank_` is the rank of each core in the current batch
+     * (lower is better), and `parbs_num_marked_` is the number of marked commands
+     * left in the batch.
+     * */
+    core_rank_array_t parbs_rank_{};
+    size_t            parbs_num_marked_ =0;
+    /*
+     * Background residency tracking (for `s_act_stby_cycles_`, etc.).
+     * */
+    size_t   num_open_banks_ =0;
+    uint64_t last_stby_update_cycle_ =0;
+    /*
+     * Data bus reservation (per sub-channel): each CAS occupies the data bus for
+     * `BL/2` cycles starting `CL` (or `CWL`) cycles after it issues. `bursts_` holds
+     * the (start, end) of bursts that may not have finished, for `update_bus_stats`.
+     * */
+    using burst_t = std::pair<uint64_t, uint64_t>;
+    using sc_cycle_array_t = std::array<uint64_t, TIMING::SUBCHANNELS>;
+    using sc_flag_array_t = std::array<bool, TIMING::SUBCHANNELS>;
+    using sc_burst_array_t = std::array<std::deque<burst_t>, TIMING::SUBCHANNELS>;
+
+    sc_cycle_array_t data_bus_free_cycle_{};
+    sc_flag_array_t  last_burst_was_write_{};
+    sc_burst_array_t bursts_;
+    uint64_t         last_bus_update_cycle_ =0;
+    sc_flag_array_t  has_queued_work_{};
+    /*
+     * Latency (in CPU cycles) from a read's issue to the end of its data burst.
+     * */
+    const uint64_t read_latency_;
 public:
-    DRAMChannel(double freq_ghz);
+    DRAMChannel(double freq_ghz, double cpu_freq_ghz);
     ~DRAMChannel(void);
     
     void tick(void);
+    /*
+     * Must be called when a transaction is added to `io_`, as the channel
+     * may be asleep until `next_event_cycle_`.
+     * */
+    inline void wake(void)
+    {
+        next_event_cycle_ = GL_DRAM_CYCLE;
+    }
+    /*
+     * Computes the energy consumed by the channel so far from the command counts
+     * and background residency (DRAMPower-style, using IDD/VDD values).
+     * */
+    DRAMEnergy compute_energy(void);
+    /*
+     * Accumulates `s_data_bus_idle_queued_cycles_` since the last update. Called
+     * every tick, and must be called before reading the stat.
+     * */
+    void update_bus_stats(void);
 private:
     using sel_cmd_t = std::optional<DRAMCommand>;
     /*
@@ -150,20 +412,126 @@ private:
      * */
     void schedule_next_cmd(void);
     void issue_next_cmd(void);
+    /*
+     * Handles the refresh of `ref_groups_[next_ref_group_]`: precharges any open
+     * banks in the group, and refreshes once all are closed. Returns true if a
+     * command was issued this cycle.
+     * */
+    bool refresh(void);
+    /*
+     * Computes `next_event_cycle_`: the earliest of refresh, any bank being able
+     * to issue, or the next cycle if there is queued work in `io_`.
+     * */
+    void update_next_event_cycle(void);
 
     bool cmd_is_issuable(const DRAMCommand&);
     void update_timing(const DRAMCommand&);
 
     sel_cmd_t frfcfs(void);
+    /*
+     * Round-robin search over the banks with commands in `[begin, end)`.
+     * */
+    sel_cmd_t frfcfs_in_range(size_t begin, size_t end);
+    sel_cmd_t frfcfs_select_from_bank(DRAMBank&);
+    /*
+     * Page policy hooks: `page_policy_close_after_cas` converts `cas` to an
+     * auto-precharge if the policy wants to close the row after it (called once
+     * `cas` is removed from its bank's queue), `page_policy_timeout` precharges
+     * an idle open bank (returns true if one was precharged), and
+     * `on_demand_pre` accounts for a precharge due to a row miss.
+     * */
+    void page_policy_close_after_cas(DRAMBank&, DRAMCommand& cas);
+    bool page_policy_timeout(void);
+    void on_demand_pre(DRAMBank&);
+    /*
+     * Marks `cmd` as a row buffer miss once a PRE or ACT is selected for it.
+     * */
+    inline void mark_row_miss(DRAMCommand& cmd)
+    {
+        if (cmd.is_row_buffer_hit)
+            cmd.cycle_row_cmd = GL_DRAM_CYCLE;
+        cmd.is_row_buffer_hit = false;
+    }
+    /*
+     * Cycle at which `page_policy_timeout` may close the bank.
+     * */
+    uint64_t page_timeout_cycle(const DRAMBank&) const;
+    /*
+     * Selects the highest priority issuable command across all banks according
+     * to `DRAM_SCHEDULER` (BLISS or PAR-BS).
+     * */
+    sel_cmd_t thread_aware_select(void);
+    void      parbs_form_batch(void);
+    /*
+     * Updates scheduler state and per-core stats once `cmd` is issued.
+     * */
+    void on_cmd_issue(const DRAMCommand& cmd);
+    /*
+     * Returns the index of the first bank at or after `idx` with a command
+     * (or set in the given mask), or `TOT_BANKS` if there is none.
+     * */
+    size_t next_bank_in_mask(size_t idx) const;
+    size_t next_bank_in_mask(const bank_mask_t&, size_t idx) const;
 
     DRAMBank& get_bank(uint64_t);
+    /*
+     * Returns the rank unit (rank within a sub-channel) of the address, and the
+     * index of its bank in `banks_`.
+     * */
+    inline static size_t rank_unit(uint64_t addr)
+    {
+        return TIMING::subchannel(addr)*TIMING::RANKS + TIMING::rank(addr);
+    }
+
+    inline static size_t bank_idx(uint64_t addr)
+    {
+        return rank_unit(addr)*BANKS_PER_RANK + TIMING::bankgroup(addr)*TIMING::BANKS + TIMING::bank(addr);
+    }
+    /*
+     * Timing update functions: `t` (or `t[0]` and `t[1]` for different and same
+     * bankgroup) must wait at least `nt` cycles from now.
+     * */
+    inline static void update(uint64_t& t, uint64_t nt)
+    {
+        t = std::max(t, GL_DRAM_CYCLE+nt);
+    }
+
+    inline static void update_SL(std::array<uint64_t,2>& t, uint64_t diff, uint64_t same)
+    {
+        update(t[0], diff);
+        update(t[1], same);
+    }
 
     void bank_update_act(DRAMBank&, uint64_t row);
     void bank_update_cas(DRAMBank&, bool is_read, bool autopre);
     void bank_update_pre(DRAMBank&);
+    /*
+     * Accumulates standby cycles since the last update. Must be called before
+     * `num_open_banks_` changes.
+     * */
+    void update_stby_cycles(void);
+    /*
+     * Recomputes `issue_ok_cycle_` and the bank's bit in `banks_with_cmd_`. Must
+     * be called whenever the bank's queue, open row, or timing changes.
+     * */
+    void bank_update_ready(DRAMBank&);
+    /*
+     * Updates the bank's bit in `banks_open_`.
+     * */
+    void set_bank_open(DRAMBank&, bool);
+    /*
+     * Returns true if the bank may precharge its open row to serve the head of
+     * its command queue.
+     * */
+    bool bank_can_pre_for_miss(const DRAMBank&);
 };
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
+#include "dram/channel.tpp"
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
 #endif  // DRAM_CHANNEL_h
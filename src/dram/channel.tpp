@@ -0,0 +1,835 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   4 December 2024
+ * */
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <tuple>
+
+#define __TEMPLATE_HEADER__ template <class TIMING>
+#define __TEMPLATE_CLASS__  DRAMChannel<TIMING>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__
+__TEMPLATE_CLASS__::DRAMChannel(double freq_ghz, double cpu_freq_ghz)
+    :io_(new IOBus(DRAM_RQ_SIZE, DRAM_WQ_SIZE, 0,
+                    WriteDrainParams{DRAM_WQ_HIGH_WM, DRAM_WQ_LOW_WM, DRAM_WRITE_MIN_BURST, DRAM_READ_PREEMPT_DRAIN})),
+    freq_ghz_(freq_ghz),
+    next_ref_cycle_(TIMING::tREFI/REF_GROUPS),
+    read_latency_(static_cast<uint64_t>(std::ceil((TIMING::CL + BL/2) * cpu_freq_ghz/freq_ghz)))
+{
+    // Assign banks to refresh groups. Consecutive groups are in different rank units, so
+    // refreshes are staggered across ranks (and sub-channels).
+    for (size_t i = 0; i < TOT_BANKS; i++) {
+        size_t ra = i / BANKS_PER_RANK,
+               g;
+        if constexpr (DRAM_REFRESH_MODE == DRAMRefreshMode::ALL_BANK) {
+            g = ra;
+        } else if constexpr (DRAM_REFRESH_MODE == DRAMRefreshMode::SAME_BANK) {
+            size_t ba = i % TIMING::BANKS;
+            g = ba*NUM_RANK_UNITS + ra;
+        } else {
+            g = (i % BANKS_PER_RANK)*NUM_RANK_UNITS + ra;
+        }
+        ref_groups_[g].push_back(i);
+    }
+}
+
+__TEMPLATE_HEADER__
+__TEMPLATE_CLASS__::~DRAMChannel() {}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::tick()
+{
+    update_bus_stats();
+
+    // Update FAW:
+    for (auto& f : faw_) {
+        while (!f.empty() && GL_DRAM_CYCLE >= f.front() + TIMING::tFAW)
+            f.pop_front();
+    }
+
+    // Banks that are not being refreshed can keep serving requests.
+    bool ref_cmd_issued = (GL_DRAM_CYCLE >= next_ref_cycle_) && refresh();
+    if (!ref_cmd_issued)
+        issue_next_cmd();
+    schedule_next_cmd();
+    update_next_event_cycle();
+
+    constexpr size_t BANKS_PER_SC = TOT_BANKS/TIMING::SUBCHANNELS;
+    for (size_t sc = 0; sc < TIMING::SUBCHANNELS; sc++)
+        has_queued_work_[sc] = io_->has_incoming() || next_bank_in_mask(sc*BANKS_PER_SC) < (sc+1)*BANKS_PER_SC;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ bool
+__TEMPLATE_CLASS__::refresh()
+{
+    const ref_group_t& grp = ref_groups_[next_ref_group_];
+    bool all_ready = true,
+         cmd_issued = false;
+    for (size_t i : grp) {
+        auto& b = banks_[i];
+        if (!b.ref_pending_) {
+            b.ref_pending_ = true;
+            bank_update_ready(b);
+        }
+        if (b.open_row_.has_value()) {
+            all_ready = false;
+            if (GL_DRAM_CYCLE >= b.pre_ok_cycle_) {
+                bank_update_pre(b);
+                cmd_issued = true;
+            }
+        } else {
+            all_ready &= GL_DRAM_CYCLE >= b.act_ok_cycle_;
+        }
+    }
+
+    if (all_ready) {
+        for (size_t i : grp) {
+            auto& b = banks_[i];
+            b.ref_pending_ = false;
+            b.closed_row_.reset();
+            update(b.act_ok_cycle_, tRFC_GROUP);
+            bank_update_ready(b);
+        }
+        next_ref_cycle_ = GL_DRAM_CYCLE + TIMING::tREFI/REF_GROUPS;
+        fast_increment_and_mod_inplace<REF_GROUPS>(next_ref_group_);
+        ++s_refreshes_;
+        cmd_issued = true;
+    }
+    return cmd_issued;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::update_next_event_cycle()
+{
+    // If there is anything to schedule or a refresh is pending, we need to
+    // tick next cycle.
+    if (io_->has_incoming() || GL_DRAM_CYCLE >= next_ref_cycle_) {
+        next_event_cycle_ = GL_DRAM_CYCLE+1;
+        return;
+    }
+    // Otherwise, wait for the refresh or the first bank that can issue.
+    uint64_t c = next_ref_cycle_;
+    for (size_t i = next_bank_in_mask(0); i < TOT_BANKS; i = next_bank_in_mask(i+1))
+        c = std::min(c, banks_[i].issue_ok_cycle_);
+    if constexpr (DRAM_PAGE_POLICY == DRAMPagePolicy::TIMEOUT) {
+        for (size_t i = next_bank_in_mask(banks_open_, 0); i < TOT_BANKS; i = next_bank_in_mask(banks_open_, i+1))
+            c = std::min(c, page_timeout_cycle(banks_[i]));
+    }
+    next_event_cycle_ = std::max(c, GL_DRAM_CYCLE+1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ DRAMEnergy
+__TEMPLATE_CLASS__::compute_energy()
+{
+    update_stby_cycles();
+
+    const double tCK = 1.0/freq_ghz_;
+    const double tRC = TIMING::tRAS + TIMING::tRP;
+    // Each command is performed by all devices of a rank (of a sub-channel). Background
+    // power is drawn by all devices in the channel.
+    const double rank_scale = VDD * (DRAM_DEVICES_PER_RANK/TIMING::SUBCHANNELS) * tCK,
+                 chan_scale = rank_scale * NUM_RANK_UNITS;
+    // ACT energy includes the PRE, and excludes the background current during tRC.
+    const double e_act = rank_scale * (IDD0*tRC - (IDD3N*TIMING::tRAS + IDD2N*TIMING::tRP)),
+                 e_rd = rank_scale * (IDD4R-IDD3N) * (BL/2),
+                 e_wr = rank_scale * (IDD4W-IDD3N) * (BL/2);
+    // Same-bank and per-bank refresh energy is the all-bank refresh current scaled
+    // by the fraction of the rank's banks being refreshed.
+    const double ref_frac = static_cast<double>(TOT_BANKS/REF_GROUPS) / (TIMING::BANKGROUPS*TIMING::BANKS),
+                 e_ref = rank_scale * (IDD5B-IDD3N) * tRFC_GROUP * ref_frac;
+
+    DRAMEnergy e;
+    e.act = e_act * s_activates_;
+    e.rd = e_rd * s_reads_;
+    e.wr = e_wr * s_writes_;
+    e.ref = e_ref * s_refreshes_;
+    e.act_stby = chan_scale * IDD3N * s_act_stby_cycles_;
+    e.pre_stby = chan_scale * IDD2N * s_pre_stby_cycles_;
+    return e;
+}
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::update_bus_stats()
+{
+    // Nothing changes between ticks, so `has_queued_work_` holds since the last update.
+    for (size_t sc = 0; sc < TIMING::SUBCHANNELS; sc++) {
+        auto& bursts = bursts_[sc];
+        if (has_queued_work_[sc]) {
+            uint64_t busy = 0;
+            for (const auto& [s, e] : bursts) {
+                uint64_t lo = std::max(s, last_bus_update_cycle_),
+                         hi = std::min(e, GL_DRAM_CYCLE);
+                if (lo < hi)
+                    busy += hi - lo;
+            }
+            s_data_bus_idle_queued_cycles_ += (GL_DRAM_CYCLE - last_bus_update_cycle_) - busy;
+        }
+        while (!bursts.empty() && bursts.front().second <= GL_DRAM_CYCLE)
+            bursts.pop_front();
+    }
+    last_bus_update_cycle_ = GL_DRAM_CYCLE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::schedule_next_cmd()
+{
+    auto tt = io_->get_next_incoming(
+                    [this] (const Transaction& t)
+                    {
+                        return this->get_bank(t.address).cmd_queue_.size() < DRAM_CMDQ_SIZE;
+                    });
+    if (tt.has_value()) {
+        Transaction& t = tt.value();
+        auto& b = get_bank(t.address);
+        b.cmd_queue_.emplace_back(t, trans_is_read(t.type) ? READ_CMD : WRITE_CMD);
+        if (b.open_row_.has_value() && b.open_row_ == TIMING::row(t.address))
+            ++b.num_row_hits_;
+        bank_update_ready(b);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::issue_next_cmd()
+{
+    sel_cmd_t _ready_cmd;
+    if constexpr (DRAM_SCHEDULER == DRAMScheduler::FRFCFS)
+        _ready_cmd = frfcfs();
+    else
+        _ready_cmd = thread_aware_select();
+    if (!_ready_cmd.has_value()) {
+        // Nothing to do for demand requests, so close idle rows if needed.
+        if constexpr (DRAM_PAGE_POLICY == DRAMPagePolicy::TIMEOUT)
+            page_policy_timeout();
+        return;
+    }
+    DRAMCommand& ready_cmd = _ready_cmd.value();
+    // Check if the command is good.
+    if (cmd_is_issuable(ready_cmd)) {
+        update_timing(ready_cmd);
+        on_cmd_issue(ready_cmd);
+        if (cmd_is_read(ready_cmd.type)) {
+            // Mark as outgoing.
+            io_->add_outgoing(ready_cmd.trans, read_latency_);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ bool
+__TEMPLATE_CLASS__::cmd_is_issuable(const DRAMCommand& cmd)
+{
+    const auto& b = get_bank(cmd.trans.address);
+    DRAMCommandType c = cmd.type;
+    // Check bank level constraints.
+    if (cmd_is_cas(c) && GL_DRAM_CYCLE < b.cas_ok_cycle_)
+        return false;
+    else if (c == DRAMCommandType::PRECHARGE && GL_DRAM_CYCLE < b.pre_ok_cycle_)
+        return false;
+    else if (c == DRAMCommandType::ACTIVATE && GL_DRAM_CYCLE < b.act_ok_cycle_)
+        return false;
+    // Now check channel level constraints.
+    size_t r = rank_unit(cmd.trans.address);
+    size_t ii = static_cast<size_t>(TIMING::bankgroup(cmd.trans.address) == last_bankgroup_[r]);
+    if (cmd_is_read(c) && GL_DRAM_CYCLE < rd_ok_cycle_[r][ii])
+        return false;
+    if (cmd_is_write(c) && GL_DRAM_CYCLE < wr_ok_cycle_[r][ii])
+        return false;
+    if (c == DRAMCommandType::ACTIVATE && (GL_DRAM_CYCLE < act_ok_cycle_[r][ii] || faw_[r].size() == 4))
+        return false;
+    // The data burst cannot overlap the previous burst (plus a turnaround if the
+    // direction changes).
+    if (cmd_is_cas(c)) {
+        bool is_write = cmd_is_write(c);
+        size_t sc = TIMING::subchannel(cmd.trans.address);
+        uint64_t burst_start = GL_DRAM_CYCLE + (is_write ? TIMING::CWL : TIMING::CL),
+                 bus_ok = data_bus_free_cycle_[sc] + (is_write != last_burst_was_write_[sc] ? TIMING::tRTRS : 0);
+        if (burst_start < bus_ok)
+            return false;
+    }
+    // Otherwise, the command meets all criteria.
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::update_timing(const DRAMCommand& cmd)
+{
+    auto& b = get_bank(cmd.trans.address);
+    DRAMCommandType c = cmd.type;
+    // Bank level updates
+    if (cmd_is_cas(c))
+        bank_update_cas(b, cmd_is_read(c), cmd_is_autopre(c));
+    else if (c == DRAMCommandType::ACTIVATE)
+        bank_update_act(b, TIMING::row(cmd.trans.address));
+    else
+        bank_update_pre(b);
+    // Now do channel-level updates
+    size_t r = rank_unit(cmd.trans.address);
+    switch (c) {
+    case DRAMCommandType::READ:
+    case DRAMCommandType::READ_PRECHARGE:
+        update_SL(rd_ok_cycle_[r], TIMING::tCCD_S, TIMING::tCCD_L);
+        update_SL(wr_ok_cycle_[r], TIMING::tCCD_S_RTW, TIMING::tCCD_L_RTW);
+        break;
+    case DRAMCommandType::WRITE:
+    case DRAMCommandType::WRITE_PRECHARGE:
+        update_SL(rd_ok_cycle_[r], TIMING::tCCD_S_WTR, TIMING::tCCD_L_WTR);
+        update_SL(wr_ok_cycle_[r], TIMING::tCCD_S_WR, TIMING::tCCD_L_WR);
+        break;
+    case DRAMCommandType::ACTIVATE:
+        update_SL(act_ok_cycle_[r], TIMING::tRRD_S, TIMING::tRRD_L);
+        faw_[r].push_back(GL_DRAM_CYCLE);
+        break;
+    default:
+        break;
+    }
+    // CAS commands to other ranks (of the same sub-channel) must wait for the
+    // data bus to switch ranks.
+    if (cmd_is_cas(c)) {
+        bool is_read = cmd_is_read(c);
+        size_t sc = TIMING::subchannel(cmd.trans.address),
+               ra = TIMING::rank(cmd.trans.address);
+        // Reserve the data bus.
+        uint64_t burst_start = GL_DRAM_CYCLE + (is_read ? TIMING::CL : TIMING::CWL);
+        data_bus_free_cycle_[sc] = burst_start + BL/2;
+        last_burst_was_write_[sc] = !is_read;
+        bursts_[sc].emplace_back(burst_start, data_bus_free_cycle_[sc]);
+        s_data_bus_busy_cycles_ += BL/2;
+
+        for (size_t r2 = sc*TIMING::RANKS; r2 < (sc+1)*TIMING::RANKS; r2++) {
+            if (r2 == r)
+                continue;
+            update_SL(rd_ok_cycle_[r2], is_read ? TIMING::tCCD_R : TIMING::tCCD_R_WTR, is_read ? TIMING::tCCD_R : TIMING::tCCD_R_WTR);
+            update_SL(wr_ok_cycle_[r2], is_read ? TIMING::tCCD_R_RTW : TIMING::tCCD_R_WR, is_read ? TIMING::tCCD_R_RTW : TIMING::tCCD_R_WR);
+        }
+        if (ra != last_cas_rank_in_sc_[sc]) {
+            ++s_rank_switches_;
+            last_cas_rank_in_sc_[sc] = ra;
+        }
+        if (r == last_cas_rank_) {
+            ++rank_cas_streak_;
+        } else {
+            last_cas_rank_ = r;
+            rank_cas_streak_ = 1;
+        }
+    }
+    last_bankgroup_[r] = TIMING::bankgroup(cmd.trans.address);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ typename __TEMPLATE_CLASS__::sel_cmd_t
+__TEMPLATE_CLASS__::frfcfs()
+{
+    // With multiple ranks, first try the rank of the last CAS to avoid rank switches.
+    if constexpr (TIMING::RANKS > 1) {
+        if (rank_cas_streak_ < RANK_STREAK_CAP) {
+            size_t begin = last_cas_rank_*BANKS_PER_RANK;
+            sel_cmd_t out = frfcfs_in_range(begin, begin+BANKS_PER_RANK);
+            if (out.has_value())
+                return out;
+        }
+    }
+    return frfcfs_in_range(0, TOT_BANKS);
+}
+
+__TEMPLATE_HEADER__ typename __TEMPLATE_CLASS__::sel_cmd_t
+__TEMPLATE_CLASS__::frfcfs_in_range(size_t begin, size_t end)
+{
+    sel_cmd_t out;
+    // Visit banks with commands in round-robin order, starting from `next_bank_with_cmd_`.
+    size_t start = std::clamp(next_bank_with_cmd_, begin, end-1);
+    for (size_t pass = 0; pass < 2; pass++) {
+        size_t pass_end = (pass == 0) ? end : start;
+        for (size_t i = next_bank_in_mask(pass == 0 ? start : begin); i < pass_end; i = next_bank_in_mask(i+1)) {
+            auto& b = banks_[i];
+            if (GL_DRAM_CYCLE < b.issue_ok_cycle_)
+                continue;
+            out = frfcfs_select_from_bank(b);
+            if (out.has_value()) {
+                next_bank_with_cmd_ = i;
+                fast_increment_and_mod_inplace<TOT_BANKS>(next_bank_with_cmd_);
+                return out;
+            }
+        }
+    }
+    return out;
+}
+
+__TEMPLATE_HEADER__ typename __TEMPLATE_CLASS__::sel_cmd_t
+__TEMPLATE_CLASS__::frfcfs_select_from_bank(DRAMBank& b)
+{
+    sel_cmd_t out;
+    auto& front = b.cmd_queue_.front();
+    // If no row is open, then we must activate the row for the head of the queue.
+    if (!b.open_row_.has_value()) {
+        DRAMCommand act(front.trans.address, DRAMCommandType::ACTIVATE);
+        act.trans.coreid = front.trans.coreid;
+        if (cmd_is_issuable(act)) {
+            mark_row_miss(front);
+            out = act;
+        }
+        return out;
+    }
+    // Row buffer miss at the head: precharge if no (or too many) row hits are pending.
+    if (bank_can_pre_for_miss(b)) {
+        DRAMCommand pre(front.trans.address, DRAMCommandType::PRECHARGE);
+        pre.trans.coreid = front.trans.coreid;
+        if (cmd_is_issuable(pre)) {
+            mark_row_miss(front);
+            on_demand_pre(b);
+            out = pre;
+            return out;
+        }
+    }
+    // Search for first cmd queue entry with row buffer hit. 
+    if (b.num_row_hits_ == 0)
+        return out;
+    for (auto cmd_it = b.cmd_queue_.begin(); cmd_it != b.cmd_queue_.end(); cmd_it++) {
+        if (b.open_row_ != TIMING::row(cmd_it->trans.address))
+            continue;
+        if (cmd_is_issuable(*cmd_it)) {
+            // Success! return the command.
+            out = *cmd_it;
+            if (cmd_it->is_row_buffer_hit)
+                ++s_row_buffer_hits_;
+            b.cmd_queue_.erase(cmd_it);
+            --b.num_row_hits_;
+            page_policy_close_after_cas(b, out.value());
+            return out;
+        }
+    }
+    return out;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ typename __TEMPLATE_CLASS__::sel_cmd_t
+__TEMPLATE_CLASS__::thread_aware_select()
+{
+    // Priority key: larger is better. The first two entries are the policy's
+    // primary criteria, followed by row hit, and finally age.
+    using key_t = std::tuple<int64_t, int64_t, int64_t, int64_t>;
+
+    if constexpr (DRAM_SCHEDULER == DRAMScheduler::BLISS) {
+        if (GL_DRAM_CYCLE >= bliss_next_clear_cycle_) {
+            bliss_blacklist_.fill(false);
+            bliss_next_clear_cycle_ = GL_DRAM_CYCLE + BLISS_CLEAR_INTERVAL;
+        }
+    } else {
+        if (parbs_num_marked_ == 0)
+            parbs_form_batch();
+    }
+
+    sel_cmd_t out;
+    std::optional<key_t> best_key;
+    DRAMBank* best_bank = nullptr;
+    DRAMBank::cmd_queue_t::iterator best_it;
+
+    for (size_t i = next_bank_in_mask(0); i < TOT_BANKS; i = next_bank_in_mask(i+1)) {
+        auto& b = banks_[i];
+        if (GL_DRAM_CYCLE < b.issue_ok_cycle_)
+            continue;
+        for (auto cmd_it = b.cmd_queue_.begin(); cmd_it != b.cmd_queue_.end(); cmd_it++) {
+            const Transaction& t = cmd_it->trans;
+            bool is_hit = b.open_row_ == TIMING::row(t.address);
+            key_t k;
+            if constexpr (DRAM_SCHEDULER == DRAMScheduler::BLISS) {
+                k = key_t{!bliss_blacklist_[t.coreid], 0, is_hit, -static_cast<int64_t>(cmd_it->cycle_enqueued)};
+            } else {
+                k = key_t{cmd_it->marked, is_hit, -static_cast<int64_t>(parbs_rank_[t.coreid]),
+                            -static_cast<int64_t>(cmd_it->cycle_enqueued)};
+            }
+            if (best_key.has_value() && k <= best_key.value())
+                continue;
+            // Get the command needed to make progress on this entry.
+            DRAMCommand cmd;
+            if (is_hit) {
+                cmd = *cmd_it;
+            } else {
+                auto c = b.open_row_.has_value() ? DRAMCommandType::PRECHARGE : DRAMCommandType::ACTIVATE;
+                cmd = DRAMCommand(t.address, c);
+                cmd.trans.coreid = t.coreid;
+            }
+            if (cmd_is_issuable(cmd)) {
+                best_key = k;
+                best_bank = &b;
+                best_it = cmd_it;
+                out = cmd;
+            }
+        }
+    }
+
+    if (out.has_value()) {
+        if (cmd_is_cas(out->type)) {
+            if (best_it->is_row_buffer_hit)
+                ++s_row_buffer_hits_;
+            best_bank->cmd_queue_.erase(best_it);
+            --best_bank->num_row_hits_;
+            page_policy_close_after_cas(*best_bank, out.value());
+        } else {
+            mark_row_miss(*best_it);
+            if (out->type == DRAMCommandType::PRECHARGE)
+                on_demand_pre(*best_bank);
+        }
+    }
+    return out;
+}
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::parbs_form_batch()
+{
+    // Mark the oldest `PARBS_MARKING_CAP` commands of each core in each bank. Command
+    // queues are in arrival order, so these are the first commands we see.
+    using core_count_array_t = std::array<size_t, NUM_THREADS>;
+
+    core_count_array_t max_bank_load{},
+                       tot_load{};
+    for (size_t i = next_bank_in_mask(0); i < TOT_BANKS; i = next_bank_in_mask(i+1)) {
+        core_count_array_t bank_load{};
+        for (auto& cmd : banks_[i].cmd_queue_) {
+            size_t c = cmd.trans.coreid;
+            if (bank_load[c] == PARBS_MARKING_CAP)
+                continue;
+            cmd.marked = true;
+            ++bank_load[c];
+            ++parbs_num_marked_;
+        }
+        for (size_t c = 0; c < NUM_THREADS; c++) {
+            max_bank_load[c] = std::max(max_bank_load[c], bank_load[c]);
+            tot_load[c] += bank_load[c];
+        }
+    }
+    // Rank cores: shortest job (lowest max bank load, then lowest total load) first.
+    std::array<size_t, NUM_THREADS> order;
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+            [&max_bank_load, &tot_load] (size_t x, size_t y)
+            {
+                return std::make_pair(max_bank_load[x], tot_load[x]) < std::make_pair(max_bank_load[y], tot_load[y]);
+            });
+    for (size_t r = 0; r < NUM_THREADS; r++)
+        parbs_rank_[order[r]] = r;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::on_cmd_issue(const DRAMCommand& cmd)
+{
+    size_t c = cmd.trans.coreid;
+    if (cmd_is_cas(cmd.type)) {
+        ++s_core_cas_[c];
+        s_core_queue_latency_[c] += GL_DRAM_CYCLE - cmd.cycle_enqueued;
+        s_core_interference_[c] += cmd.interference;
+
+        if (cmd_is_read(cmd.type)) {
+            uint64_t first_cmd_cycle = (cmd.cycle_row_cmd > 0) ? cmd.cycle_row_cmd : GL_DRAM_CYCLE;
+            s_rq_wait_hist_.add(cmd.cycle_enqueued - cmd.trans.dram_cycle_arrived);
+            s_cmdq_wait_hist_.add(first_cmd_cycle - cmd.cycle_enqueued);
+            if (cmd.cycle_row_cmd > 0)
+                s_row_miss_hist_.add(GL_DRAM_CYCLE - cmd.cycle_row_cmd);
+            s_read_latency_hist_.add(GL_DRAM_CYCLE + TIMING::CL + BL/2 - cmd.trans.dram_cycle_arrived);
+        }
+
+        if constexpr (DRAM_SCHEDULER == DRAMScheduler::BLISS) {
+            if (c == bliss_last_core_) {
+                if (++bliss_streak_ >= BLISS_THRESHOLD)
+                    bliss_blacklist_[c] = true;
+            } else {
+                bliss_last_core_ = c;
+                bliss_streak_ = 1;
+            }
+        } else if constexpr (DRAM_SCHEDULER == DRAMScheduler::PARBS) {
+            if (cmd.marked)
+                --parbs_num_marked_;
+        }
+    }
+    // Any command from other cores waiting on this bank is delayed by this command.
+    uint64_t busy;
+    if (cmd_is_cas(cmd.type))
+        busy = TIMING::tCCD_L;
+    else if (cmd.type == DRAMCommandType::ACTIVATE)
+        busy = TIMING::tRCD;
+    else
+        busy = TIMING::tRP;
+    for (auto& x : get_bank(cmd.trans.address).cmd_queue_) {
+        if (x.trans.coreid != c)
+            x.interference += busy;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::page_policy_close_after_cas(DRAMBank& b, DRAMCommand& cas)
+{
+    if constexpr (DRAM_PAGE_POLICY == DRAMPagePolicy::PREDICTIVE) {
+        // Close the row after its last pending hit if the predictor expects a miss.
+        if (b.num_row_hits_ == 0 && b.row_hit_ctr_ < 2) {
+            cas.type = cmd_is_read(cas.type) ? DRAMCommandType::READ_PRECHARGE
+                                             : DRAMCommandType::WRITE_PRECHARGE;
+        }
+    }
+}
+
+__TEMPLATE_HEADER__ bool
+__TEMPLATE_CLASS__::page_policy_timeout()
+{
+    for (size_t i = next_bank_in_mask(banks_open_, 0); i < TOT_BANKS; i = next_bank_in_mask(banks_open_, i+1)) {
+        auto& b = banks_[i];
+        if (GL_DRAM_CYCLE >= page_timeout_cycle(b)) {
+            b.closed_row_ = b.open_row_;
+            bank_update_pre(b);
+            return true;
+        }
+    }
+    return false;
+}
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::on_demand_pre(DRAMBank& b)
+{
+    ++s_pre_demand_;
+    if (b.num_row_hits_ == 0 && b.num_cas_to_open_row_ > 0) {
+        // The row was dead, so it should have been closed earlier.
+        ++s_pre_late_;
+        if (b.row_hit_ctr_ > 0)
+            --b.row_hit_ctr_;
+    }
+}
+
+__TEMPLATE_HEADER__ uint64_t
+__TEMPLATE_CLASS__::page_timeout_cycle(const DRAMBank& b) const
+{
+    if (b.num_row_hits_ > 0 || b.ref_pending_)
+        return std::numeric_limits<uint64_t>::max();
+    return std::max(b.pre_ok_cycle_, b.last_cas_cycle_ + DRAM_PAGE_TIMEOUT);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ size_t
+__TEMPLATE_CLASS__::next_bank_in_mask(size_t idx) const
+{
+    return next_bank_in_mask(banks_with_cmd_, idx);
+}
+
+__TEMPLATE_HEADER__ size_t
+__TEMPLATE_CLASS__::next_bank_in_mask(const bank_mask_t& mask, size_t idx) const
+{
+    size_t ii = idx >> 6;
+    if (ii >= BANK_MASK_WIDTH)
+        return TOT_BANKS;
+    // Check the remainder of the first word, then the remaining words.
+    uint64_t w = mask[ii] & (~0ull << (idx & 0x3f));
+    while (w == 0) {
+        if (++ii == BANK_MASK_WIDTH)
+            return TOT_BANKS;
+        w = mask[ii];
+    }
+    return (ii << 6) | __builtin_ctzll(w);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ DRAMBank&
+__TEMPLATE_CLASS__::get_bank(uint64_t addr)
+{
+    return banks_.at(bank_idx(addr));
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::bank_update_act(DRAMBank& b, uint64_t row)
+{
+    update_stby_cycles();
+    ++num_open_banks_;
+
+    // Check if the page policy closed this row too early.
+    if (b.closed_row_.has_value()) {
+        if (b.closed_row_ == row) {
+            ++s_pre_premature_;
+            if (b.row_hit_ctr_ < 3)
+                ++b.row_hit_ctr_;
+        } else if (b.row_hit_ctr_ > 0) {
+            --b.row_hit_ctr_;
+        }
+        b.closed_row_.reset();
+    }
+    set_bank_open(b, true);
+
+    b.open_row_ = row;
+    b.num_row_hits_ = std::count_if(b.cmd_queue_.begin(), b.cmd_queue_.end(),
+                            [row] (const DRAMCommand& c)
+                            {
+                                return TIMING::row(c.trans.address) == row;
+                            });
+    update(b.cas_ok_cycle_, TIMING::tRCD);
+    update(b.pre_ok_cycle_, TIMING::tRAS);
+    ++s_activates_;
+
+    bank_update_ready(b);
+}
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::bank_update_cas(DRAMBank& b, bool is_read, bool autopre)
+{
+    uint64_t cas_to_pre = is_read ? TIMING::tRTP : (BL/2 + TIMING::CWL + TIMING::tWR);
+    b.last_cas_cycle_ = GL_DRAM_CYCLE;
+    // A second hit to the open row means keeping it open paid off.
+    if (b.num_cas_to_open_row_ > 0 && b.row_hit_ctr_ < 3)
+        ++b.row_hit_ctr_;
+    if (autopre) {
+        update_stby_cycles();
+        --num_open_banks_;
+        set_bank_open(b, false);
+
+        b.closed_row_ = b.open_row_;
+        b.open_row_.reset();
+        b.num_cas_to_open_row_ = 0;
+        b.num_row_hits_ = 0;
+        update(b.act_ok_cycle_, cas_to_pre + TIMING::tRP);
+
+        ++s_precharges_;
+    } else {
+        ++b.num_cas_to_open_row_;
+        update(b.pre_ok_cycle_, cas_to_pre);
+    }
+    if (is_read)
+        ++s_reads_;
+    else
+        ++s_writes_;
+
+    bank_update_ready(b);
+}
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::bank_update_pre(DRAMBank& b)
+{
+    update_stby_cycles();
+    --num_open_banks_;
+    set_bank_open(b, false);
+
+    b.open_row_.reset();
+    b.num_cas_to_open_row_ = 0;
+    b.num_row_hits_ = 0;
+
+    update(b.act_ok_cycle_, TIMING::tRP);
+
+    ++s_precharges_;
+
+    bank_update_ready(b);
+}
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::update_stby_cycles()
+{
+    uint64_t elapsed = GL_DRAM_CYCLE - last_stby_update_cycle_;
+    if (num_open_banks_ > 0)
+        s_act_stby_cycles_ += elapsed;
+    else
+        s_pre_stby_cycles_ += elapsed;
+    last_stby_update_cycle_ = GL_DRAM_CYCLE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::bank_update_ready(DRAMBank& b)
+{
+    size_t idx = std::distance(banks_.data(), &b);
+    uint64_t bit = 1ull << (idx & 0x3f);
+    if (b.cmd_queue_.empty()) {
+        banks_with_cmd_[idx >> 6] &= ~bit;
+        return;
+    }
+    banks_with_cmd_[idx >> 6] |= bit;
+
+    if (b.ref_pending_) {
+        b.issue_ok_cycle_ = std::numeric_limits<uint64_t>::max();
+    } else if (!b.open_row_.has_value()) {
+        b.issue_ok_cycle_ = b.act_ok_cycle_;
+    } else {
+        b.issue_ok_cycle_ = std::numeric_limits<uint64_t>::max();
+        if (b.num_row_hits_ > 0)
+            b.issue_ok_cycle_ = b.cas_ok_cycle_;
+        // Thread-aware schedulers may precharge for any row miss.
+        bool can_pre = (DRAM_SCHEDULER == DRAMScheduler::FRFCFS)
+                        ? bank_can_pre_for_miss(b) : (b.num_row_hits_ < b.cmd_queue_.size());
+        if (can_pre)
+            b.issue_ok_cycle_ = std::min(b.issue_ok_cycle_, b.pre_ok_cycle_);
+    }
+}
+
+__TEMPLATE_HEADER__ void
+__TEMPLATE_CLASS__::set_bank_open(DRAMBank& b, bool open)
+{
+    if constexpr (DRAM_PAGE_POLICY == DRAMPagePolicy::TIMEOUT) {
+        size_t idx = std::distance(banks_.data(), &b);
+        uint64_t bit = 1ull << (idx & 0x3f);
+        if (open)
+            banks_open_[idx >> 6] |= bit;
+        else
+            banks_open_[idx >> 6] &= ~bit;
+    }
+}
+
+__TEMPLATE_HEADER__ bool
+__TEMPLATE_CLASS__::bank_can_pre_for_miss(const DRAMBank& b)
+{
+    // Only precharge if the head of the queue misses, and there are no pending
+    // row hits (or the open row has been used enough).
+    const auto& front = b.cmd_queue_.front();
+    if (b.open_row_ == TIMING::row(front.trans.address))
+        return false;
+    return b.num_row_hits_ == 0 || b.num_cas_to_open_row_ >= DRAM_MAX_ROW_HITS;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#undef __TEMPLATE_HEADER__
+#undef __TEMPLATE_CLASS__
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
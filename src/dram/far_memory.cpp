@@ -0,0 +1,54 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#include "dram/far_memory.h"
+#include "io_bus.h"
+
+#include <algorithm>
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+FarMemory::FarMemory(double cpu_freq_ghz)
+    :io_(new IOBus(FAR_MEM_QUEUE_SIZE, FAR_MEM_QUEUE_SIZE, 0)),
+    latency_(static_cast<uint64_t>(std::ceil(FAR_MEM_LATENCY_NS * cpu_freq_ghz))),
+    line_cycles_(LINESIZE * cpu_freq_ghz / FAR_MEM_BANDWIDTH_GBPS)
+{}
+
+FarMemory::~FarMemory() {}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+FarMemory::tick()
+{
+    const double now = static_cast<double>(GL_CYCLE);
+    while (io_->has_incoming()) {
+        // Only take transactions whose link direction is free.
+        auto tt = io_->get_next_incoming(
+                        [this, now] (const Transaction& t)
+                        {
+                            bool is_read = trans_is_read(t.type);
+                            return (is_read ? rd_link_free_cycle_ : wr_link_free_cycle_) <= now;
+                        });
+        if (!tt.has_value())
+            return;
+        const Transaction& t = tt.value();
+        if (trans_is_read(t.type)) {
+            // The request is sent immediately, but the data must wait for the link.
+            rd_link_free_cycle_ = std::max(rd_link_free_cycle_, now) + line_cycles_;
+            io_->add_outgoing(t, latency_ + static_cast<uint64_t>(std::ceil(line_cycles_)));
+            ++s_reads_;
+        } else {
+            wr_link_free_cycle_ = std::max(wr_link_free_cycle_, now) + line_cycles_;
+            ++s_writes_;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,57 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef DRAM_FAR_MEMORY_h
+#define DRAM_FAR_MEMORY_h
+
+#include "constants.h"
+#include "globals.h"
+
+#include <cstdint>
+#include <memory>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Defined in `io_bus.h`
+ * */
+class IOBus;
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Models a far memory device (i.e., a CXL Type-3 memory expander) as a fixed
+ * latency behind a full-duplex link: reads and writes each get `FAR_MEM_BANDWIDTH_GBPS`.
+ * Unlike `DRAMChannel`, this runs at the CPU clock and has no banks.
+ * */
+class FarMemory
+{
+public:
+    using io_ptr = std::unique_ptr<IOBus>;
+
+    uint64_t s_reads_ =0;
+    uint64_t s_writes_ =0;
+
+    io_ptr io_;
+    /*
+     * `latency_` is the device latency of a read, and `line_cycles_` is the
+     * number of cycles a line occupies the link. Both are in CPU cycles.
+     * */
+    const uint64_t latency_;
+    const double   line_cycles_;
+private:
+    double rd_link_free_cycle_ =0.0;
+    double wr_link_free_cycle_ =0.0;
+public:
+    FarMemory(double cpu_freq_ghz);
+    ~FarMemory(void);
+
+    void tick(void);
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // DRAM_FAR_MEMORY_h
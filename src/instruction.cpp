@@ -94,7 +94,8 @@ Instruction::Instruction(uint64_t inst_num, const ChampsimTraceFormat& blk)
 ////////////////////////////////////////////////////////////////////////////
 
 Instruction::Instruction(const MemsimTraceFormat& blk)
-    :inst_num(0)
+    :inst_num(0),
+    ip(0)
 {
     uint64_t addr{};
     memcpy(&inst_num, blk.inst_num, sizeof(blk.inst_num));
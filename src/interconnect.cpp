@@ -0,0 +1,174 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#include "interconnect.h"
+#include "util/stats.h"
+
+#include <algorithm>
+#include <numeric>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+extern uint64_t GL_CYCLE;
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+static size_t
+_mesh_width(size_t n)
+{
+    size_t w = 1;
+    while (w*w < n)
+        ++w;
+    return w;
+}
+
+static size_t
+_num_stops(size_t num_slices)
+{
+    size_t n = std::max(NUM_THREADS, num_slices);
+    if constexpr (NOC_TOPOLOGY == NOCTopology::MESH) {
+        // Round up to a full mesh.
+        size_t w = _mesh_width(n);
+        return w * ((n+w-1)/w);
+    } else {
+        return n;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+Interconnect::Interconnect(size_t num_slices)
+    :num_slices_(num_slices),
+    num_stops_(_num_stops(num_slices)),
+    mesh_width_(_mesh_width(num_stops_)),
+    s_link_busy_(4*num_stops_, 0),
+    link_free_(4*num_stops_, 0)
+{}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+uint64_t
+Interconnect::traverse(size_t src, size_t dst, size_t bytes, bool send)
+{
+    if (src == dst)
+        return 0;
+    route(src, dst);
+
+    const uint64_t flits = (bytes + NOC_LINK_WIDTH-1) / NOC_LINK_WIDTH;
+    uint64_t t = GL_CYCLE,
+             queueing = 0;
+    for (size_t l : route_buf_) {
+        t += NOC_ROUTER_LATENCY;
+        uint64_t depart = std::max(t, link_free_[l]);
+        queueing += depart - t;
+        if (send) {
+            link_free_[l] = depart + flits;
+            s_link_busy_[l] += flits;
+        }
+        // One cycle for the head flit to cross the link.
+        t = depart+1;
+    }
+    // The tail flit arrives `flits-1` cycles after the head.
+    t += flits-1;
+
+    if (send) {
+        ++s_messages_;
+        s_flits_ += flits;
+        s_hops_ += route_buf_.size();
+        s_tot_latency_ += t - GL_CYCLE;
+        s_tot_queueing_ += queueing;
+    }
+    return t - GL_CYCLE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+Interconnect::print_stats(std::ostream& out)
+{
+    // Only count links that exist (mesh stops on an edge have fewer links).
+    std::vector<double> util;
+    for (size_t s = 0; s < num_stops_; s++) {
+        for (size_t d = 0; d < 4; d++) {
+            if constexpr (NOC_TOPOLOGY == NOCTopology::RING) {
+                if (d >= 2)
+                    continue;
+            } else {
+                size_t x = s % mesh_width_,
+                       y = s / mesh_width_;
+                if ((d == 0 && x == mesh_width_-1) || (d == 1 && x == 0)
+                    || (d == 2 && y == 0) || (d == 3 && y == num_stops_/mesh_width_-1))
+                {
+                    continue;
+                }
+            }
+            util.push_back(mean(s_link_busy_[4*s+d], GL_CYCLE));
+        }
+    }
+    double util_mean = util.empty() ? 0.0 : std::accumulate(util.begin(), util.end(), 0.0) / util.size();
+    double util_max = util.empty() ? 0.0 : *std::max_element(util.begin(), util.end());
+
+    out << BAR << "\n";
+    print_stat(out, "NOC", "MESSAGES", s_messages_);
+    print_stat(out, "NOC", "FLITS", s_flits_);
+    print_stat(out, "NOC", "AVG_HOPS", mean(s_hops_, s_messages_));
+    print_stat(out, "NOC", "AVG_LATENCY", mean(s_tot_latency_, s_messages_));
+    print_stat(out, "NOC", "AVG_QUEUEING_DELAY", mean(s_tot_queueing_, s_messages_));
+    print_stat(out, "NOC", "LINK_UTILIZATION_MEAN", util_mean);
+    print_stat(out, "NOC", "LINK_UTILIZATION_MAX", util_max);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+Interconnect::route(size_t src, size_t dst)
+{
+    route_buf_.clear();
+    if constexpr (NOC_TOPOLOGY == NOCTopology::RING) {
+        size_t cw = (dst + num_stops_ - src) % num_stops_;
+        bool go_cw = cw <= num_stops_-cw;
+        size_t hops = go_cw ? cw : num_stops_-cw;
+        size_t s = src;
+        for (size_t i = 0; i < hops; i++) {
+            route_buf_.push_back(2*s + (go_cw ? 0 : 1));
+            s = go_cw ? (s+1) % num_stops_ : (s+num_stops_-1) % num_stops_;
+        }
+    } else {
+        // XY routing: first along the row, then along the column.
+        size_t x = src % mesh_width_,
+               y = src / mesh_width_;
+        const size_t dx = dst % mesh_width_,
+                     dy = dst / mesh_width_;
+        while (x != dx) {
+            size_t s = y*mesh_width_ + x;
+            if (x < dx) {
+                route_buf_.push_back(4*s + 0);
+                ++x;
+            } else {
+                route_buf_.push_back(4*s + 1);
+                --x;
+            }
+        }
+        while (y != dy) {
+            size_t s = y*mesh_width_ + x;
+            if (y > dy) {
+                route_buf_.push_back(4*s + 2);
+                --y;
+            } else {
+                route_buf_.push_back(4*s + 3);
+                ++y;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
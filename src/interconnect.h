@@ -0,0 +1,116 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef INTERCONNECT_h
+#define INTERCONNECT_h
+
+#include "constants.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * `NONE` only models a fixed latency per hop between cores and LLC slices (see
+ * `SlicedCacheControl`).
+ * */
+enum class NOCTopology { NONE, RING, MESH };
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * On-chip interconnect between the cores, the LLC slices and the memory controller.
+ *
+ * The interconnect has `num_stops` routers, each with a link to its neighbors (two on
+ * a bidirectional ring, up to four on a 2D mesh). Cores and slices are spread evenly
+ * over the stops, and the memory controller sits at the last stop. Ring messages take
+ * the shortest direction, and mesh messages use XY routing.
+ *
+ * A message is split into flits of `NOC_LINK_WIDTH` bytes. At each hop, it spends
+ * `NOC_ROUTER_LATENCY` cycles in the router, waits until the output link is free
+ * (the queueing delay), and then holds the link for one cycle per flit. Links are
+ * reserved when a message is sent, so the latency of a message is known at once.
+ * */
+class Interconnect
+{
+public:
+    /*
+     * Size of a message without data (requests), and with a line of data (responses
+     * and writebacks).
+     * */
+    constexpr static size_t CONTROL_BYTES = 8;
+    constexpr static size_t DATA_BYTES = CONTROL_BYTES + LINESIZE;
+
+    const size_t num_slices_;
+    const size_t num_stops_;
+    /*
+     * Width of the mesh (the mesh has `num_stops_/mesh_width_` rows).
+     * */
+    const size_t mesh_width_;
+
+    uint64_t s_messages_ =0;
+    uint64_t s_flits_ =0;
+    uint64_t s_hops_ =0;
+    uint64_t s_tot_latency_ =0;
+    uint64_t s_tot_queueing_ =0;
+    /*
+     * Cycles each link was busy (indexed like `link_free_`).
+     * */
+    std::vector<uint64_t> s_link_busy_;
+private:
+    /*
+     * Ring links are indexed by `2*stop + dir` (`dir = 0` is clockwise). Mesh links
+     * are indexed by `4*stop + dir`, where `dir` is east, west, north or south.
+     * */
+    std::vector<uint64_t> link_free_;
+    std::vector<size_t>   route_buf_;
+public:
+    Interconnect(size_t num_slices);
+    /*
+     * Sends a message of `bytes` from `src` to `dst` in the current cycle, and returns
+     * the cycles until it arrives.
+     * */
+    inline uint64_t send(size_t src, size_t dst, size_t bytes)
+    {
+        return traverse(src, dst, bytes, true);
+    }
+    /*
+     * Returns the latency `send` would return, without sending the message.
+     * */
+    inline uint64_t latency(size_t src, size_t dst, size_t bytes)
+    {
+        return traverse(src, dst, bytes, false);
+    }
+
+    void print_stats(std::ostream&);
+
+    inline size_t core_stop(uint8_t coreid) const
+    {
+        return (coreid * num_stops_) / NUM_THREADS;
+    }
+
+    inline size_t slice_stop(size_t slice_idx) const
+    {
+        return (slice_idx * num_stops_) / num_slices_;
+    }
+
+    inline size_t mc_stop(void) const
+    {
+        return num_stops_-1;
+    }
+private:
+    uint64_t traverse(size_t src, size_t dst, size_t bytes, bool send);
+    /*
+     * Writes the links from `src` to `dst` into `route_buf_`.
+     * */
+    void route(size_t src, size_t dst);
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // INTERCONNECT_h
@@ -17,9 +17,14 @@ extern uint64_t GL_CYCLE;
 ////////////////////////////////////////////////////////////////////////////
 
 IOBus::IOBus(size_t r, size_t w, size_t p)
+    :IOBus(r, w, p, WriteDrainParams{w})
+{}
+
+IOBus::IOBus(size_t r, size_t w, size_t p, WriteDrainParams d)
     :rq_size_(r),
     wq_size_(w),
-    pq_size_(p)
+    pq_size_(p),
+    drain_(d)
 {}
 
 ////////////////////////////////////////////////////////////////////////////
@@ -34,15 +39,31 @@ IOBus::add_incoming(Transaction t)
             add_outgoing(t, 1);
         return true;
     }
-    // Same thing for reads: merge if there is an existing read already.
+    // Same thing for reads: merge if there is an existing read already. Only reads from
+    // the same core are merged, as the response goes to the core of the pending read (cores
+    // may read the same line if they share an address space).
     if (trans_is_read(t.type) && pending_reads_.count(t.address)) {
-        auto rd_it = std::find_if(read_queue_.begin(), read_queue_.end(),
-                            [addr = t.address] (const Transaction& x)
-                            {
-                                return x.address == addr;
-                            });
-        rd_it->merge(t);
-        return true;
+        // Prefetches are not needed if the line is already being read.
+        if (t.type == TransactionType::PREFETCH)
+            return true;
+        auto match = [addr = t.address, coreid = t.coreid] (const Transaction& x)
+                    {
+                        return x.address == addr && x.coreid == coreid;
+                    };
+        auto rd_it = std::find_if(read_queue_.begin(), read_queue_.end(), match);
+        if (rd_it != read_queue_.end()) {
+            // A demand read takes over a pending migration read of the same line.
+            if (rd_it->type == TransactionType::MIGRATION)
+                rd_it->type = t.type;
+            rd_it->merge(t);
+            return true;
+        }
+        // Otherwise, if the pending read is a prefetch, the demand read replaces it.
+        auto pf_it = std::find_if(prefetch_queue_.begin(), prefetch_queue_.end(), match);
+        if (pf_it != prefetch_queue_.end()) {
+            dec_pending(pending_reads_, pf_it->address);
+            prefetch_queue_.erase(pf_it);
+        }
     }
     // Add to requisite queue.
     if (trans_is_read(t.type)) {
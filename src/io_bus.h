@@ -16,6 +16,25 @@
 
 #include "transaction.h"
 
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Controls when `IOBus` drains its write queue:
+ *  a drain starts once the write queue reaches `high_wm` (or once reads are idle
+ *  and the write queue has more than `low_wm` writes, and at least 8), and drains
+ *  until `low_wm` of the writes present at the start remain.
+ *
+ *  If `read_preempt` is set, waiting reads end a drain once at least `min_burst`
+ *  writes have been drained, unless the write queue is still at `high_wm`.
+ * */
+struct WriteDrainParams
+{
+    size_t high_wm;
+    size_t low_wm =0;
+    size_t min_burst =0;
+    bool   read_preempt =false;
+};
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
@@ -47,13 +66,24 @@ public:
     out_queue_t outgoing_queue_;
 
     uint64_t s_blocking_writes_ =0;
+    /*
+     * Number of switches between serving reads and writes, and the number of
+     * calls to `get_next_incoming` made while draining writes.
+     * */
+    uint64_t s_rd_to_wr_turnarounds_ =0;
+    uint64_t s_wr_to_rd_turnarounds_ =0;
+    uint64_t s_drain_cycles_ =0;
     /*
      * Queue sizes for each of the input queues.
      * */
     const size_t rq_size_;
     const size_t wq_size_;
     const size_t pq_size_;
+
+    const WriteDrainParams drain_;
 private:
+    constexpr static size_t IDLE_DRAIN_MIN = 8;
+
     using in_queue_t = std::deque<Transaction>;
     using pending_t = std::unordered_map<uint64_t, size_t>;
     /*
@@ -67,8 +97,11 @@ private:
     pending_t pending_writes_;
 
     size_t writes_to_drain_ =0;
+    size_t writes_in_burst_ =0;
+    bool   last_was_write_ =false;
 public:
     IOBus(size_t rq_size, size_t wq_size, size_t pq_size);
+    IOBus(size_t rq_size, size_t wq_size, size_t pq_size, WriteDrainParams);
     /*
      * Returns the next available transaction (if one exists). If a
      * predicate is provided, the selected transaction will only be
@@ -87,6 +120,18 @@ public:
      * */
     bool add_incoming(Transaction);
     void add_outgoing(Transaction, uint64_t latency);
+    /*
+     * Returns true if any of the input queues are non-empty.
+     * */
+    inline bool has_incoming(void) const
+    {
+        return !read_queue_.empty() || !write_queue_.empty() || !prefetch_queue_.empty();
+    }
+
+    inline size_t prefetch_queue_free(void) const
+    {
+        return pq_size_ - prefetch_queue_.size();
+    }
     /*
      * Searches for references to the instruction in the queues. 
      * Returns true if found and writes to stderr.
@@ -100,6 +145,15 @@ private:
         if ((--p[addr]) == 0)
             p.erase(addr);
     }
+
+    inline void update_turnaround(bool is_write)
+    {
+        if (is_write && !last_was_write_)
+            ++s_rd_to_wr_turnarounds_;
+        else if (!is_write && last_was_write_)
+            ++s_wr_to_rd_turnarounds_;
+        last_was_write_ = is_write;
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////
@@ -109,12 +163,24 @@ template <class PRED> IOBus::opt_trans_t
 IOBus::get_next_incoming(PRED pred)
 {
     opt_trans_t out;
-    // Need to drain writes if the queue is full, or we can also
+    // Need to drain writes if the queue is past the high watermark, or we can also
     // do it if there is nothing left to do.
-    bool write_drain_cond = write_queue_.size() == wq_size_
-                            || (read_queue_.empty() && prefetch_queue_.empty() && write_queue_.size() > 8);
-    if (writes_to_drain_ == 0 && write_drain_cond)
-        writes_to_drain_ = write_queue_.size();
+    bool reads_waiting = !read_queue_.empty() || !prefetch_queue_.empty();
+    bool write_drain_cond = write_queue_.size() >= drain_.high_wm
+                            || (!reads_waiting && write_queue_.size() > std::max(IDLE_DRAIN_MIN, drain_.low_wm));
+    if (writes_to_drain_ == 0 && write_drain_cond) {
+        writes_to_drain_ = write_queue_.size() - std::min(drain_.low_wm, write_queue_.size());
+        writes_in_burst_ = 0;
+    }
+    // Let reads preempt the drain once the burst is long enough.
+    bool preempt = drain_.read_preempt 
+                    && reads_waiting 
+                    && writes_in_burst_ >= drain_.min_burst 
+                    && write_queue_.size() < drain_.high_wm;
+    if (writes_to_drain_ > 0 && preempt)
+        writes_to_drain_ = 0;
+    if (writes_to_drain_ > 0)
+        ++s_drain_cycles_;
 
     bool access_done = false;
     if (writes_to_drain_ > 0) {
@@ -129,6 +195,8 @@ IOBus::get_next_incoming(PRED pred)
 
             dec_pending(pending_writes_, w_it->address);
             --writes_to_drain_;
+            ++writes_in_burst_;
+            update_turnaround(true);
 
             if (!read_queue_.empty() || !prefetch_queue_.empty())
                 ++s_blocking_writes_;
@@ -144,6 +212,7 @@ IOBus::get_next_incoming(PRED pred)
         if (r_it != q.end()) {
             out = *r_it;
             dec_pending(pending_reads_, r_it->address);
+            update_turnaround(false);
             q.erase(r_it);
         }
     }
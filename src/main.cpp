@@ -8,6 +8,7 @@
 #include "globals.h"
 #include "sim.h"
 
+#include "cache/directory.h"
 #include "util/argparse.h"
 
 ////////////////////////////////////////////////////////////////////////////
@@ -19,6 +20,7 @@ core_array_t GL_CORES;
 os_ptr       GL_OS;
 llc_ptr      GL_LLC;
 dram_ptr     GL_DRAM;
+directory_ptr GL_DIRECTORY;
 
 std::string OPT_TRACE_FILE;
 uint64_t OPT_INST_SIM;
@@ -77,7 +79,9 @@ int main(int argc, char* argv[])
         size_t ii = curr_core_idx;
         for (size_t i = 0; i < NUM_THREADS; i++) {
             auto& c = GL_CORES[ii];
-            c->tick();
+            // Cores do nothing while handling a TLB shootdown.
+            if (GL_CYCLE >= GL_OS->migrator_.core_stall_until_[ii])
+                c->tick();
             if (!c->done_ && c->finished_inst_num_ >= OPT_INST_SIM) {
                 c->checkpoint_stats();
                 c->done_ = true;
@@ -97,6 +101,7 @@ int main(int argc, char* argv[])
     std::cout << "\n";
     for (size_t i = 0; i < NUM_THREADS; i++)
         GL_CORES[i]->print_stats(std::cout);
+    print_slice_stats(GL_LLC, std::cout);
     GL_DRAM->print_stats(std::cout);
     GL_OS->print_stats(std::cout);
 
@@ -8,34 +8,161 @@
 
 #include <cstddef>
 #include <iostream>
-#include <numeric>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+FramePool::FramePool(uint64_t base_pfn, size_t num_frames, uint64_t seed)
+    :base_pfn_(base_pfn),
+    num_frames_(num_frames),
+    free_page_frames_(num_frames/64, 0),
+    free_counts_(num_count_levels(num_frames/64, COUNT_FANOUT)),
+    rng_(seed)
+{
+    if (num_frames_ == 0) {
+        free_counts_[0].assign(1, 0);
+        return;
+    }
+    // Initialize the count tree: all page frames are free.
+    size_t children = free_page_frames_.size();
+    uint64_t frames_per_child = 64;
+    for (count_level_t& lvl : free_counts_) {
+        size_t width = (children + COUNT_FANOUT-1) / COUNT_FANOUT;
+        uint64_t frames_per_node = frames_per_child*COUNT_FANOUT;
+        
+        lvl.assign(width, frames_per_node);
+        // The last node may not be full.
+        lvl.back() = num_frames_ - (width-1)*frames_per_node;
+
+        children = width;
+        frames_per_child = frames_per_node;
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
 uint64_t
-FreeList::get_and_reserve_free_page_frame()
+FramePool::get_and_reserve()
 {
-    ++s_page_faults_;
-    for (size_t i = 0; i < 2048; i++) {
-        size_t pfn = fast_mod<NUM_PAGE_FRAMES>(rng_());
-        size_t ii = pfn >> 6,
-               jj = pfn & 0x3f;
-        bool is_taken = free_page_frames_[ii] & (1L << jj);
+    // Try a few random probes first -- these almost always succeed
+    // when memory is mostly free.
+    for (size_t i = 0; i < NUM_FAST_PROBES; i++) {
+        uint64_t idx = rng_() % num_frames_;
+        bool is_taken = free_page_frames_[idx >> 6] & (1L << (idx & 0x3f));
         if (!is_taken) {
-            free_page_frames_[ii] |= (1L << jj);
-            return pfn;
+            reserve(idx);
+            return base_pfn_ + idx;
         }
     }
-    size_t num_free = std::accumulate(free_page_frames_.begin(), free_page_frames_.end(), 0ull,
-                                        [] (uint64_t x, uint64_t y)
-                                        {
-                                            return x + __builtin_popcount(~y);
-                                        });
-    std::cerr << "free list: failed to find free page frame, free page frames: " << num_free
-        << ", total = " << NUM_PAGE_FRAMES << "\n";
-    exit(1);
+    uint64_t idx = find_free_page_frame_by_descent();
+    reserve(idx);
+    return base_pfn_ + idx;
+}
+
+void
+FramePool::release(uint64_t pfn)
+{
+    uint64_t idx = pfn - base_pfn_;
+    size_t ii = idx >> 6,
+           jj = idx & 0x3f;
+    free_page_frames_[ii] &= ~(1L << jj);
+
+    for (count_level_t& lvl : free_counts_) {
+        ii /= COUNT_FANOUT;
+        ++lvl[ii];
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
+
+uint64_t
+FramePool::find_free_page_frame_by_descent()
+{
+    // Pick the `r`-th free page frame (uniformly at random), and find it by
+    // walking down the count tree.
+    uint64_t r = rng_() % num_free();
+    size_t idx = 0;
+    for (size_t i = free_counts_.size()-1; i > 0; i--) {
+        const count_level_t& lvl = free_counts_[i-1];
+        size_t j = idx*COUNT_FANOUT;
+        while (r >= lvl[j]) {
+            r -= lvl[j];
+            ++j;
+        }
+        idx = j;
+    }
+    // `idx` is now the index of a group of words in `free_page_frames_`.
+    size_t ii = idx*COUNT_FANOUT;
+    while (true) {
+        uint64_t cnt = __builtin_popcountll(~free_page_frames_[ii]);
+        if (r < cnt)
+            break;
+        r -= cnt;
+        ++ii;
+    }
+    // Select the `r`-th free bit in the word.
+    uint64_t free_bits = ~free_page_frames_[ii];
+    for (size_t k = 0; k < r; k++)
+        free_bits &= free_bits-1;
+    return (ii << 6) | __builtin_ctzll(free_bits);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+FramePool::reserve(uint64_t idx)
+{
+    size_t ii = idx >> 6,
+           jj = idx & 0x3f;
+    free_page_frames_[ii] |= (1L << jj);
+
+    for (count_level_t& lvl : free_counts_) {
+        ii /= COUNT_FANOUT;
+        --lvl[ii];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+uint64_t
+FreeList::get_and_reserve_free_page_frame()
+{
+    ++s_page_faults_;
+    if (num_free_page_frames() == 0) {
+        std::cerr << "free list: failed to find free page frame, free page frames: 0"
+            << ", total = " << NUM_PAGE_FRAMES+NUM_FAR_PAGE_FRAMES << "\n";
+        exit(1);
+    }
+    MemTier tier = MemTier::NEAR_MEM;
+    if constexpr (MEM_PLACEMENT == MemPlacement::INTERLEAVE) {
+        if (interleave_idx_ == MEM_INTERLEAVE_WEIGHT)
+            tier = MemTier::FAR_MEM;
+        fast_increment_and_mod_inplace<MEM_INTERLEAVE_WEIGHT+1>(interleave_idx_);
+    }
+    // Spill into the other tier if the selected tier is full.
+    if (num_free_page_frames(tier) == 0)
+        tier = (tier == MemTier::NEAR_MEM) ? MemTier::FAR_MEM : MemTier::NEAR_MEM;
+    if (tier == MemTier::FAR_MEM)
+        ++s_far_page_faults_;
+    return pool(tier).get_and_reserve();
+}
+
+uint64_t
+FreeList::get_and_reserve_free_page_frame(MemTier tier)
+{
+    return pool(tier).get_and_reserve();
+}
+
+void
+FreeList::release_page_frame(uint64_t pfn)
+{
+    pool(page_frame_tier(pfn)).release(pfn);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
@@ -11,36 +11,147 @@
 #include <array>
 #include <cstdint>
 #include <random>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
 constexpr size_t NUM_PAGE_FRAMES = (DRAM_SIZE_MB*1024*1024) / PAGESIZE;
+/*
+ * Far memory page frames are numbered after the DRAM page frames.
+ * */
+constexpr size_t NUM_FAR_PAGE_FRAMES = (FAR_MEM_SIZE_MB*1024*1024) / PAGESIZE;
+
+/*
+ * Number of levels needed to summarize `n` entries with the given fanout,
+ * down to a single root entry.
+ * */
+constexpr inline size_t num_count_levels(size_t n, size_t fanout)
+{
+    size_t k = (n + fanout-1) / fanout;
+    return k <= 1 ? 1 : 1 + num_count_levels(k, fanout);
+}
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
-class FreeList
+enum class MemTier { NEAR_MEM, FAR_MEM };
+/*
+ * `FIRST_TOUCH`: pages are placed in DRAM until it is full, and then in far memory.
+ * `INTERLEAVE`: every `MEM_INTERLEAVE_WEIGHT` pages placed in DRAM are followed by
+ *              one page placed in far memory.
+ * `HOTNESS`: pages are placed as in `FIRST_TOUCH`, and hot pages in far memory are
+ *              periodically promoted to DRAM (see `PageMigrator`).
+ * */
+enum class MemPlacement { FIRST_TOUCH, INTERLEAVE, HOTNESS };
+
+inline MemTier page_frame_tier(uint64_t pfn)
+{
+    return pfn < NUM_PAGE_FRAMES ? MemTier::NEAR_MEM : MemTier::FAR_MEM;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Manages the page frames `[base_pfn, base_pfn + num_frames)` of a single tier.
+ * */
+class FramePool
 {
 public:
-    uint64_t s_page_faults_ =0;
+    const uint64_t base_pfn_;
+    const size_t   num_frames_;
 private:
-    constexpr static size_t BITVEC_WIDTH = NUM_PAGE_FRAMES/64;
+    /*
+     * Each level of the count tree summarizes `COUNT_FANOUT` entries of the level
+     * below it (level 0 summarizes words of `free_page_frames_`). The last level
+     * always has a single entry: the total number of free page frames.
+     * */
+    constexpr static size_t COUNT_FANOUT = 64;
+    /*
+     * Number of random probes into `free_page_frames_` before we fall back to
+     * the count tree. The probes keep allocation identical to plain random
+     * probing while memory is mostly free.
+     * */
+    constexpr static size_t NUM_FAST_PROBES = 4;
 
-    using free_bitvec_t = std::array<uint64_t, BITVEC_WIDTH>;
+    using free_bitvec_t = std::vector<uint64_t>;
+    using count_level_t = std::vector<uint64_t>;
+    using count_tree_t = std::vector<count_level_t>;
     /*
      * Page frame management. `free_page_frames_` uses active-low as available,
      * and `rng` is used for randomized page allocation.
+     *
+     * `free_counts_` tracks the number of free page frames under each node, so
+     * a uniformly random free frame can be found by a weighted descent from the
+     * root, regardless of how full memory is.
      * */
-    free_bitvec_t free_page_frames_{};
-    std::mt19937_64 rng_{0};
+    free_bitvec_t free_page_frames_;
+    count_tree_t  free_counts_;
+    std::mt19937_64 rng_;
+public:
+    FramePool(uint64_t base_pfn, size_t num_frames, uint64_t seed);
+    /*
+     * Returns a free, random page frame and reserves it. The pool must not be full.
+     * */
+    uint64_t get_and_reserve(void);
+    void     release(uint64_t pfn);
+
+    inline uint64_t num_free(void) const
+    {
+        return free_counts_.back().at(0);
+    }
+private:
+    uint64_t find_free_page_frame_by_descent(void);
+    void     reserve(uint64_t idx);
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+class FreeList
+{
+public:
+    uint64_t s_page_faults_ =0;
+    /*
+     * Number of page faults that were placed in far memory.
+     * */
+    uint64_t s_far_page_faults_ =0;
+private:
+    FramePool near_{0, NUM_PAGE_FRAMES, 0};
+    FramePool far_{NUM_PAGE_FRAMES, NUM_FAR_PAGE_FRAMES, 1};
+    /*
+     * Position in the interleaving pattern (for `MemPlacement::INTERLEAVE`).
+     * */
+    size_t interleave_idx_ =0;
 public:
     FreeList(void) =default;
     /*
-     * Searches for a free, random page frame. If found, then returns this pfn.
-     * Otherwise, prints to `stderr` and exits with code 1.
+     * Searches for a free, random page frame in the tier selected by `MEM_PLACEMENT`.
+     * If that tier is full, the other tier is used. If found, then returns this pfn.
+     * Otherwise (all page frames are taken), prints to `stderr` and exits with code 1.
      * */
     uint64_t get_and_reserve_free_page_frame(void);
+    /*
+     * Used for page migration: returns a free page frame in the given tier,
+     * which must not be full. This does not count as a page fault.
+     * */
+    uint64_t get_and_reserve_free_page_frame(MemTier);
+    void     release_page_frame(uint64_t pfn);
+
+    inline uint64_t num_free_page_frames(void) const
+    {
+        return near_.num_free() + far_.num_free();
+    }
+
+    inline uint64_t num_free_page_frames(MemTier tier) const
+    {
+        return (tier == MemTier::NEAR_MEM) ? near_.num_free() : far_.num_free();
+    }
+private:
+    inline FramePool& pool(MemTier tier)
+    {
+        return (tier == MemTier::NEAR_MEM) ? near_ : far_;
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,135 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#include "dram.h"
+#include "os/migration.h"
+#include "util/stats.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+PageMigrator::PageMigrator(FreeList& fl)
+    :free_list_(fl)
+{}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+PageMigrator::migration_list_t
+PageMigrator::migrate()
+{
+    // (access count, pfn)
+    using heat_t = std::pair<uint64_t, uint64_t>;
+
+    next_epoch_cycle_ += MIGRATION_EPOCH;
+    auto& accesses = GL_DRAM->page_accesses_;
+
+    // Find the hottest pages in far memory.
+    std::vector<heat_t> hot;
+    for (const auto& [pfn, cnt] : accesses) {
+        if (cnt >= MIGRATION_HOT_THRESHOLD && page_frame_tier(pfn) == MemTier::FAR_MEM && owners_.count(pfn))
+            hot.emplace_back(cnt, pfn);
+    }
+    size_t num_hot = std::min(hot.size(), MIGRATION_MAX_PAGES);
+    std::partial_sort(hot.begin(), hot.begin()+num_hot, hot.end(), std::greater<heat_t>());
+    hot.resize(num_hot);
+    // If DRAM cannot fit all of them, find the coldest pages in DRAM to swap with.
+    std::vector<heat_t> cold;
+    size_t num_free = free_list_.num_free_page_frames(MemTier::NEAR_MEM);
+    if (num_hot > num_free) {
+        for (const auto& [pfn, owner] : owners_) {
+            if (page_frame_tier(pfn) != MemTier::NEAR_MEM)
+                continue;
+            auto it = accesses.find(pfn);
+            cold.emplace_back(it == accesses.end() ? 0 : it->second, pfn);
+        }
+        size_t num_cold = std::min(cold.size(), num_hot - num_free);
+        std::partial_sort(cold.begin(), cold.begin()+num_cold, cold.end());
+        cold.resize(num_cold);
+    }
+
+    migration_list_t out;
+    size_t j = 0;
+    for (const auto& [cnt, far_pfn] : hot) {
+        PageOwner far_owner = owners_.at(far_pfn);
+        if (free_list_.num_free_page_frames(MemTier::NEAR_MEM) > 0) {
+            uint64_t near_pfn = free_list_.get_and_reserve_free_page_frame(MemTier::NEAR_MEM);
+            move_page(far_owner, far_pfn, near_pfn, out);
+
+            owners_.erase(far_pfn);
+            free_list_.release_page_frame(far_pfn);
+            accesses[near_pfn] = cnt;
+            accesses.erase(far_pfn);
+        } else if (j < cold.size() && cold[j].first < cnt) {
+            uint64_t near_pfn = cold[j].second;
+            PageOwner near_owner = owners_.at(near_pfn);
+            move_page(far_owner, far_pfn, near_pfn, out);
+            move_page(near_owner, near_pfn, far_pfn, out);
+
+            std::swap(accesses[near_pfn], accesses[far_pfn]);
+            ++s_demotions_;
+            ++j;
+        } else {
+            break;
+        }
+        ++s_promotions_;
+    }
+    // Halve all access counts.
+    for (auto it = accesses.begin(); it != accesses.end(); ) {
+        it->second >>= 1;
+        if (it->second == 0)
+            it = accesses.erase(it);
+        else
+            ++it;
+    }
+    // Shoot down the TLBs of each core that had a page migrated (once per epoch). If
+    // the cores share an address space, any core may have the page in its TLB.
+    std::array<bool, NUM_THREADS> needs_shootdown{};
+    for (const Migration& m : out) {
+        if constexpr (OS_SHARED_ADDRESS_SPACE)
+            needs_shootdown.fill(true);
+        else
+            needs_shootdown[m.coreid] = true;
+    }
+    for (size_t i = 0; i < NUM_THREADS; i++) {
+        if (needs_shootdown[i]) {
+            core_stall_until_[i] = GL_CYCLE + TLB_SHOOTDOWN_CYCLES;
+            ++s_tlb_shootdowns_[i];
+        }
+    }
+    if (!out.empty())
+        ++s_epochs_with_migrations_;
+    return out;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+PageMigrator::print_stats(std::ostream& out)
+{
+    print_stat(out, "OS", "PAGE_PROMOTIONS", s_promotions_);
+    print_stat(out, "OS", "PAGE_DEMOTIONS", s_demotions_);
+    print_stat(out, "OS", "EPOCHS_WITH_MIGRATIONS", s_epochs_with_migrations_);
+    print_vecstat(out, "OS", "TLB_SHOOTDOWNS", s_tlb_shootdowns_);
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+void
+PageMigrator::move_page(PageOwner owner, uint64_t src_pfn, uint64_t dst_pfn, migration_list_t& out)
+{
+    GL_DRAM->migrate_page(src_pfn, dst_pfn, owner.coreid);
+    owners_[dst_pfn] = owner;
+    out.push_back(Migration{owner.coreid, owner.vpn, dst_pfn});
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,104 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   19 October 2026
+ * */
+
+#ifndef OS_MIGRATION_h
+#define OS_MIGRATION_h
+
+#include "constants.h"
+#include "globals.h"
+#include "os/free_list.h"
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Moves pages between DRAM and far memory for `MemPlacement::HOTNESS`.
+ *
+ * At the end of each `MIGRATION_EPOCH`, up to `MIGRATION_MAX_PAGES` far memory
+ * pages with at least `MIGRATION_HOT_THRESHOLD` accesses (see `DRAM::page_accesses_`)
+ * are promoted to DRAM, hottest first. If DRAM is full, each promoted page is swapped
+ * with the coldest DRAM page, as long as that page is colder. Access counts are then
+ * halved, so hotness carries over between epochs.
+ *
+ * Each migration copies the page in memory (see `DRAM::migrate_page`), and each core
+ * that owns a migrated page is stalled for `TLB_SHOOTDOWN_CYCLES` for a single
+ * (batched) TLB shootdown.
+ * */
+class PageMigrator
+{
+public:
+    /*
+     * A migration moves `vpn` of core `coreid` to page frame `pfn`. The OS
+     * must update its page table accordingly.
+     * */
+    struct Migration
+    {
+        uint8_t  coreid;
+        uint64_t vpn;
+        uint64_t pfn;
+    };
+
+    using migration_list_t = std::vector<Migration>;
+    using core_stat_t = std::array<uint64_t, NUM_THREADS>;
+
+    uint64_t s_promotions_ =0;
+    uint64_t s_demotions_ =0;
+    uint64_t s_epochs_with_migrations_ =0;
+    core_stat_t s_tlb_shootdowns_{};
+    /*
+     * Cores are not ticked before this cycle (they are handling a TLB shootdown).
+     * */
+    core_stat_t core_stall_until_{};
+private:
+    struct PageOwner
+    {
+        uint8_t  coreid;
+        uint64_t vpn;
+    };
+    /*
+     * Maps page frames holding data pages (not page tables) to their owners. These
+     * are the only page frames that can be migrated.
+     * */
+    using owner_map_t = std::unordered_map<uint64_t, PageOwner>;
+
+    constexpr static bool ENABLED = (MEM_PLACEMENT == MemPlacement::HOTNESS) && (FAR_MEM_SIZE_MB > 0);
+
+    owner_map_t owners_;
+    FreeList&   free_list_;
+
+    uint64_t next_epoch_cycle_ =MIGRATION_EPOCH;
+public:
+    PageMigrator(FreeList&);
+
+    inline void register_page(uint64_t pfn, uint8_t coreid, uint64_t vpn)
+    {
+        if constexpr (ENABLED)
+            owners_[pfn] = PageOwner{coreid, vpn};
+    }
+
+    inline bool epoch_done(void) const
+    {
+        return ENABLED && GL_CYCLE >= next_epoch_cycle_;
+    }
+    /*
+     * Selects and performs the migrations for this epoch. Should only be called
+     * once `epoch_done` returns true.
+     * */
+    migration_list_t migrate(void);
+
+    void print_stats(std::ostream&);
+private:
+    void move_page(PageOwner, uint64_t src_pfn, uint64_t dst_pfn, migration_list_t&);
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#endif  // OS_MIGRATION_h
@@ -34,9 +34,9 @@ Core::tick_warmup()
 
     if (inst != nullptr) {
         for (Memop& x : inst->loads)
-            GL_LLC->warmup_access(x.p_lineaddr, false);
+            GL_LLC->warmup_access(x.p_lineaddr, false, inst->ip, coreid_);
         for (Memop& x : inst->stores)
-            GL_LLC->warmup_access(x.p_lineaddr, true);
+            GL_LLC->warmup_access(x.p_lineaddr, true, inst->ip, coreid_);
     }
 }
 
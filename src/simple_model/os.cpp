@@ -15,12 +15,17 @@ constexpr size_t TAG_OFFSET = 48;
 uint64_t
 OS::translate_lineaddr(uint64_t lineaddr, uint8_t coreid)
 {
-    // First, tag the line address with the coreid.
-    lineaddr |= static_cast<uint64_t>(coreid) << TAG_OFFSET;
+    // First, tag the line address with the coreid (unless the cores share an
+    // address space).
+    if constexpr (!OS_SHARED_ADDRESS_SPACE)
+        lineaddr |= static_cast<uint64_t>(coreid) << TAG_OFFSET;
 
     auto [vpn, offset] = split_address<LINESIZE>(lineaddr);
-    if (!pt_.count(vpn))
-        pt_.insert({vpn, free_list_.get_and_reserve_free_page_frame()});
+    if (!pt_.count(vpn)) {
+        uint64_t pfn = free_list_.get_and_reserve_free_page_frame();
+        pt_.insert({vpn, pfn});
+        migrator_.register_page(pfn, coreid, vpn);
+    }
     uint64_t pfn = pt_.at(vpn);
     return join_address<LINESIZE>(pfn, offset);
 }
@@ -28,11 +33,27 @@ OS::translate_lineaddr(uint64_t lineaddr, uint8_t coreid)
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
+void
+OS::tick()
+{
+    if (migrator_.epoch_done()) {
+        for (const auto& m : migrator_.migrate())
+            pt_.at(m.vpn) = m.pfn;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
 void
 OS::print_stats(std::ostream& out)
 {
     out << BAR << "\n";
     print_stat(out, "OS", "PAGE_FAULTS", free_list_.s_page_faults_);
+    if constexpr (FAR_MEM_SIZE_MB > 0) {
+        print_stat(out, "OS", "FAR_MEM_PAGE_FAULTS", free_list_.s_far_page_faults_);
+        migrator_.print_stats(out);
+    }
     out << BAR << "\n";
 }
 
@@ -7,6 +7,7 @@
 #define SIMPLE_MODEL_OS_h
 
 #include "os/free_list.h"
+#include "os/migration.h"
 
 #include <cstdint>
 #include <iosfwd>
@@ -18,7 +19,8 @@
 class OS
 {
 public:
-    FreeList free_list_{};
+    FreeList     free_list_{};
+    PageMigrator migrator_{free_list_};
 private:
     using page_table_t = std::unordered_map<uint64_t, uint64_t>;
 
@@ -26,9 +28,9 @@ private:
 public:
     OS(void) =default;
     /*
-     * `tick` needs to do nothing. This exists for compatibility.
+     * `tick` only needs to handle page migrations.
      * */ 
-    void tick(void) {}
+    void tick(void);
 
     uint64_t translate_lineaddr(uint64_t, uint8_t coreid);
     void print_stats(std::ostream&);
@@ -12,9 +12,17 @@
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
-enum class TransactionType { READ, WRITE, PREFETCH, TRANSLATION };
+/*
+ * `MIGRATION` reads copy a line out of a page that is being migrated between memory
+ * tiers. They are never returned to the requester.
+ * */
+enum class TransactionType { READ, WRITE, PREFETCH, TRANSLATION, MIGRATION };
 
 bool trans_is_read(TransactionType);
+/*
+ * Defined in `cache/prefetch.h`
+ * */
+enum class CachePrefetcher;
 
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -39,6 +47,20 @@ struct Transaction
 
     uint64_t address;
     bool     address_is_ip;
+    /*
+     * DRAM cycle at which the transaction entered a memory channel's queues
+     * (used for DRAM latency stats).
+     * */
+    uint64_t dram_cycle_arrived =0;
+    /*
+     * The prefetcher that issued a `PREFETCH` (`NONE` otherwise).
+     * */
+    CachePrefetcher pf_source{};
+    /*
+     * Cycles the request spent in the interconnect on the way to an LLC slice (added
+     * to the latency of the response, see `SlicedCacheControl`).
+     * */
+    uint64_t noc_latency =0;
 
     Transaction(uint8_t cid, iptr_t, TransactionType, uint64_t addr, bool addr_is_ip=false);
     Transaction(const Transaction&) =default;
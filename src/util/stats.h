@@ -8,6 +8,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
 #include <numeric>
@@ -74,6 +76,80 @@ vec_hmean(const VecStat<T,N>& arr)
     return static_cast<double>(N) / denom;
 }
 
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+/*
+ * Histogram with log-scaled buckets: bucket 0 holds 0, and bucket `i > 0` holds
+ * `[2^(i-1), 2^i)`. The last bucket also holds anything larger.
+ * */
+struct LogHistogram
+{
+    constexpr static size_t NUM_BUCKETS = 32;
+
+    std::array<uint64_t, NUM_BUCKETS> buckets{};
+    uint64_t count =0;
+    uint64_t sum =0;
+    uint64_t max =0;
+
+    inline static size_t bucket(uint64_t x)
+    {
+        size_t b = (x == 0) ? 0 : 64 - __builtin_clzll(x);
+        return std::min(b, NUM_BUCKETS-1);
+    }
+
+    inline static uint64_t bucket_lower_bound(size_t b)
+    {
+        return (b == 0) ? 0 : (1ull << (b-1));
+    }
+
+    inline void add(uint64_t x)
+    {
+        ++buckets[bucket(x)];
+        ++count;
+        sum += x;
+        max = std::max(max, x);
+    }
+
+    inline double amean(void) const
+    {
+        return static_cast<double>(sum) / static_cast<double>(count);
+    }
+    /*
+     * Estimates the `p`-th percentile (`p` in `[0,1]`) by interpolating within
+     * the bucket that contains it.
+     * */
+    inline double percentile(double p) const
+    {
+        if (count == 0)
+            return 0.0;
+        double target = p * count;
+        uint64_t cum = 0;
+        for (size_t b = 0; b < NUM_BUCKETS; b++) {
+            if (buckets[b] == 0 || cum + buckets[b] < target) {
+                cum += buckets[b];
+                continue;
+            }
+            if (b == 0)
+                return 0.0;
+            double lo = bucket_lower_bound(b),
+                   hi = (b == NUM_BUCKETS-1) ? max : std::min(bucket_lower_bound(b+1), max+1);
+            double x = lo + (hi - lo) * (target - cum) / buckets[b];
+            return std::min(x, static_cast<double>(max));
+        }
+        return max;
+    }
+
+    inline LogHistogram& operator+=(const LogHistogram& other)
+    {
+        for (size_t b = 0; b < NUM_BUCKETS; b++)
+            buckets[b] += other.buckets[b];
+        count += other.count;
+        sum += other.sum;
+        max = std::max(max, other.max);
+        return *this;
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
@@ -32,6 +32,14 @@ print_cache_stats_for_core_header(std::ostream& out)
         << std::setw(16) << std::left << "MISS_PENALTY"
         << std::setw(16) << std::left << "WRITEBACKS"
         << std::setw(16) << std::left << "WRITE_BLOCKED"
+        << std::setw(16) << std::left << "PF_REQUESTED"
+        << std::setw(16) << std::left << "PF_DROPPED"
+        << std::setw(16) << std::left << "PF_ISSUED"
+        << std::setw(16) << std::left << "PF_USEFUL"
+        << std::setw(16) << std::left << "PF_LATE"
+        << std::setw(16) << std::left << "PF_USELESS"
+        << std::setw(16) << std::left << "PF_POLLUTION"
+        << std::setw(16) << std::left << "PF_META"
         << "\n" << BAR << "\n";
 }
 
@@ -41,21 +49,21 @@ print_cache_stats_for_core_header(std::ostream& out)
 template <class CORE, class CACHE> inline void
 print_cache_stats_for_core(CORE* c, const std::unique_ptr<CACHE>& cache, std::ostream& out, std::string_view header)
 {
-    uint8_t id = c->coreid_;
     uint64_t inst = c->finished_inst_num_;
-    
-    uint64_t accesses = cache->s_accesses_.at(id),
-             misses = cache->s_misses_.at(id),
-             invalidates = cache->s_invalidates_.at(id),
-             write_alloc = cache->s_write_alloc_.at(id);
+    const auto st = cache->stats_for_core(c->coreid_);
+
+    uint64_t accesses = st.accesses,
+             misses = st.misses,
+             invalidates = st.invalidates,
+             write_alloc = st.write_alloc;
 
     double apki = mean(accesses, inst) * 1000.0,
            mpki = mean(misses, inst) * 1000.0;
-    double miss_penalty = misses == 0 ? 0.0 : mean(cache->s_tot_penalty_.at(id), cache->s_num_penalty_.at(id));
+    double miss_penalty = misses == 0 ? 0.0 : mean(st.tot_penalty, st.num_penalty);
     double miss_rate = mean(misses, accesses);
     double aat = CACHE::CACHE_LATENCY * (1-miss_rate) + miss_penalty*miss_rate;
 
-    uint64_t write_blocked_cycles = cache->io_->s_blocking_writes_ / CACHE::NUM_RW_PORTS;
+    uint64_t write_blocked_cycles = st.blocking_writes / CACHE::NUM_RW_PORTS;
 
     out << std::setw(16) << std::left << header
         << std::setw(16) << std::left << accesses
@@ -67,8 +75,16 @@ print_cache_stats_for_core(CORE* c, const std::unique_ptr<CACHE>& cache, std::os
         << std::setw(16) << std::left << std::setprecision(3) << mpki
         << std::setw(16) << std::left << std::setprecision(3) << aat
         << std::setw(16) << std::left << std::setprecision(3) << miss_penalty
-        << std::setw(16) << std::left << cache->s_writebacks_
+        << std::setw(16) << std::left << st.writebacks
         << std::setw(16) << std::left << write_blocked_cycles
+        << std::setw(16) << std::left << st.pf_requested
+        << std::setw(16) << std::left << st.pf_dropped
+        << std::setw(16) << std::left << st.pf_issued
+        << std::setw(16) << std::left << st.pf_useful
+        << std::setw(16) << std::left << st.pf_late
+        << std::setw(16) << std::left << st.pf_useless
+        << std::setw(16) << std::left << st.pf_pollution
+        << std::setw(16) << std::left << st.pf_meta_accesses
         << "\n";
 }
 